@@ -1,16 +1,54 @@
 #ifndef DAEMON_H
 #define DAEMON_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 typedef struct {
     int from;
     int to;
     char* filename;
 } connection_t;
 
+/* header in front of every packet in the ring */
+typedef struct {
+    uint16_t from;
+    uint16_t to;
+    uint32_t packet_id;
+} packet_header_t;
+
 #define MESSAGE_SIZE 128    
+#define PACKET_PAYLOAD_SIZE 104 /* bytes of file per packet, the filter works per packet */
 #define MINIMUM_PORT 0          /* this will always be 0 */
 #define MAXIMUM_PORT 128
 #define NUMBER_OF_PROCESSING_THREADS 4
+#define RINGBUFFER_SIZE 1024
+
+typedef enum {
+    DAEMON_RING_LOCKED = 0, /* rbctx_t, one mutex shared by all threads */
+    DAEMON_RING_MPMC,       /* mpmc_rbctx_t, lock-free fixed MESSAGE_SIZE slots */
+    DAEMON_RING_GROUP,      /* rbgroup_t, one rbctx_t lane per group of connections */
+    DAEMON_RING_SHM,        /* shm_rbctx_t, other processes can write packets too */
+    DAEMON_RING_ELASTIC,    /* elastic_rbctx_t, grows from ring_size under load and shrinks back */
+} daemon_ring_t;
+
+#define DAEMON_SHM_NAME "/simpledaemon"
+#define DAEMON_ELASTIC_GROWTH 64    /* default ring_size_max is this many times ring_size */
+#define DAEMON_SPILL_SIZE (16 << 20)  /* default spill_size */
+
+typedef struct {
+    daemon_ring_t ring;
+    size_t ring_size;                   /* bytes of ring memory, per lane for DAEMON_RING_GROUP */
+    size_t ring_size_max;               /* DAEMON_RING_ELASTIC only, 0 is DAEMON_ELASTIC_GROWTH * ring_size */
+    int number_of_processing_threads;
+    int number_of_lanes;                /* DAEMON_RING_GROUP only, 0 is one lane per connection */
+    int measure_latency;                /* DAEMON_RING_LOCKED/GROUP, time packets spend in the ring (RBUF_TIMESTAMPS) */
+    const char* shm_name;               /* DAEMON_RING_SHM only, NULL is DAEMON_SHM_NAME. Producer processes
+                                         * shm_ringbuffer_open it and write a packet_header_t followed by the payload */
+    const char* spill_dir;              /* DAEMON_RING_LOCKED only, packets that don't fit go to a file in this
+                                         * directory instead of waiting (ringbuffer_spill), NULL is no spilling */
+    size_t spill_size;                  /* bytes of the spill file, 0 is DAEMON_SPILL_SIZE */
+} daemon_options_t;
 
 /**
  * @brief simpledaemon
@@ -21,4 +59,17 @@ typedef struct {
  */
 int simpledaemon(connection_t *connections, int number_of_connections);
 
+/**
+ * @brief simpledaemon with a selectable ring implementation, ring size and
+ * number of processing threads (for measuring contention scaling).
+ * simpledaemon() uses DAEMON_RING_LOCKED, RINGBUFFER_SIZE and NUMBER_OF_PROCESSING_THREADS.
+ *
+ * @param connections
+ * @param number_of_connections
+ * @param options
+ * @return 0 once all packets are handled, 1 if ring_size is below MESSAGE_SIZE or
+ *         number_of_processing_threads is not positive
+ */
+int simpledaemon_with_options(connection_t *connections, int number_of_connections, const daemon_options_t *options);
+
 #endif
\ No newline at end of file
@@ -8,21 +8,108 @@
 #include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #define SUCCESS 0
 #define RINGBUFFER_FULL 1
 #define RINGBUFFER_EMPTY 2
 #define OUTPUT_BUFFER_TOO_SMALL 3
+#define RINGBUFFER_INVALID 4
+#define RINGBUFFER_CLOSED 5   /* ringbuffer_close was called, writes fail and reads once it is drained */
+
+#define RBUF_CACHELINE 64
+
+#define RBUF_TIMEOUT 1   /* seconds ringbuffer_write/ringbuffer_read wait at most */
+
+/* special deadlines for the *_until calls */
+#define RBUF_NO_WAIT 0
+#define RBUF_WAIT_FOREVER UINT64_MAX
+
+/* context flags */
+#define RBUF_MIRRORED 0x1   /* memory is mapped twice back-to-back, see ringbuffer_init_mirrored */
+#define RBUF_VARINT 0x2     /* 1 byte length prefix up to 127 bytes, 2 up to 16383, ... instead of sizeof(size_t) */
+#define RBUF_POW2 0x4       /* power-of-two size, positions are head/tail masked, no byte kept free */
+#define RBUF_TIMESTAMPS 0x8 /* every message carries its enqueue time, reads feed ringbuffer_latency */
+#define RBUF_HUGEPAGES 0x10 /* ringbuffer_create: MAP_HUGETLB pages, transparent huge pages if none are reserved */
+#define RBUF_PREFAULT 0x20  /* ringbuffer_create: fault all pages in up front (MAP_POPULATE) */
+#define RBUF_WAIT_SPIN 0x40     /* blocking calls busy-spin with pause instead of parking, for pinned threads */
+#define RBUF_WAIT_BACKOFF 0x80  /* blocking calls spin, then sched_yield, then park */
+#define RBUF_EVENTFD 0x100      /* eventfds for poll/epoll, see ringbuffer_read_fd and ringbuffer_poll */
+
+/* wait strategy, rounds before the next stage */
+#define RBUF_SPIN_ROUNDS 1000   /* pause instructions between checks of the ringbuffer, none on a single CPU */
+#define RBUF_YIELD_ROUNDS 16    /* sched_yield calls of RBUF_WAIT_BACKOFF before parking */
+
+#define RBUF_NUMA_ANY (-1)  /* ringbuffer_create: no NUMA binding */
+
+/* latency histogram: 2^RBUF_HIST_SUB_BITS buckets per power of two ns (12.5% resolution) */
+#define RBUF_HIST_SUB_BITS 3
+#define RBUF_HIST_BUCKETS (64 << RBUF_HIST_SUB_BITS)
+
+typedef struct {
+    uint64_t count;
+    uint64_t max_ns;
+    uint64_t buckets[RBUF_HIST_BUCKETS];
+} rbhist_t;
 
-#define RBUF_TIMEOUT 1
+/* percentiles of the time messages spent in the ringbuffer, see ringbuffer_latency */
+typedef struct {
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+} rblatency_t;
+
+/* counters of ringbuffer_stats, updated under the mutex the calls take anyway */
+typedef struct {
+    uint64_t messages_in;
+    uint64_t messages_out;
+    uint64_t bytes_in;      //message bytes, without length prefixes
+    uint64_t bytes_out;
+    uint64_t full;          //calls that returned RINGBUFFER_FULL
+    uint64_t empty;         //calls that returned RINGBUFFER_EMPTY
+    uint64_t timeouts;      //waits that ended at their deadline
+    uint64_t spilled;       //messages written to the spill file, see ringbuffer_spill
+    uint64_t wait_ns;       //time spent waiting, spinning included
+    size_t high_water;      //most bytes stored at once, length prefixes included
+} rbstats_t;
 
 typedef struct {
     uint8_t* read;
     uint8_t* write;
     uint8_t* begin;
     uint8_t* end; //1 step AFTER the last readable address
+    uint64_t head;  //bytes ever written, in RBUF_POW2 mode write == begin + (head & mask)
+    uint64_t tail;  //bytes ever read, in RBUF_POW2 mode read == begin + (tail & mask)
+    size_t mask;    //size - 1 in RBUF_POW2 mode
     pthread_mutex_t mtx;
-    pthread_cond_t sig;
+    pthread_cond_t not_empty;   //readers park here, CLOCK_MONOTONIC
+    pthread_cond_t not_full;    //writers park here, CLOCK_MONOTONIC
+    int read_waiters;
+    int write_waiters;
+    uint64_t read_wakeups;  //bumped by every wakeup of readers, RBUF_WAIT_SPIN/BACKOFF readers poll it
+    uint64_t write_wakeups; //same for writers
+    int flags;
+    uint8_t* reserved;  //payload handed out by ringbuffer_write_reserve, NULL if none
+    size_t reserved_len;
+    uint8_t* peeked;    //message end handed out by ringbuffer_read_peek, NULL if none
+    rbstats_t stats;
+    rbhist_t* latency;  //allocated in RBUF_TIMESTAMPS mode, NULL otherwise
+    size_t mapped_len;  //memory mapped by ringbuffer_create, 0 otherwise
+    int read_fd;        //RBUF_EVENTFD: readable while messages are waiting, -1 otherwise
+    int write_fd;       //RBUF_EVENTFD: readable while there is room, -1 otherwise
+    int fd_state;       //RBUF_EVENTFD: RB_FD_READ/RB_FD_WRITE bits of the signalled fds
+    uint8_t* spill;     //mapped spill file, NULL without ringbuffer_spill
+    size_t spill_size;
+    size_t spill_head;  //offset the next spilled message is written at, the file wraps around like the memory
+    size_t spill_tail;  //offset of the oldest spilled message
+    int closed;         //set by ringbuffer_close, never reset
+    struct rbbell* bell;    //shared by the lanes of a ringbuffer_group, rung on new messages, NULL otherwise
 } rbctx_t;
 
 /**
@@ -35,13 +122,83 @@ typedef struct {
  */
 void ringbuffer_init(rbctx_t *context, void *buffer_location, size_t buffer_size);
 
+/**
+ * Initialize a ringbuffer with non-default behaviour.
+ * Generate ringbuffer context and memory before initialization.
+ *
+ * @param context ringbuffer context.
+ * @param buffer_location the first byte location of the ringbuffer in memory
+ * @param buffer_size size of the ringbuffer (and memory)
+ * @param flags context flags, e.g. RBUF_VARINT | RBUF_POW2, at most one wait strategy (RBUF_WAIT_SPIN/BACKOFF),
+ *        parking on a condition without one
+ * @return SUCCESS on success, RINGBUFFER_INVALID if buffer_size is 0, RBUF_POW2 is set and buffer_size is no power of two,
+ *         both wait strategies are set or the RBUF_TIMESTAMPS histogram or RBUF_EVENTFD fds could not be allocated
+ */
+int ringbuffer_init_flags(rbctx_t *context, void *buffer_location, size_t buffer_size, int flags);
+
+/**
+ * Initialize a ringbuffer whose memory is mapped twice back-to-back.
+ * The ringbuffer allocates its own memory (a memfd mapped at begin and
+ * again at end), so a message that crosses end is still contiguous in
+ * virtual memory and reads/writes never have to be split in two copies.
+ * The memory is released by ringbuffer_destroy.
+ *
+ * @param context ringbuffer context.
+ * @param buffer_size size of the ringbuffer, rounded up to a multiple of the page size
+ * @param flags context flags, e.g. RBUF_VARINT
+ * @return SUCCESS on success, RINGBUFFER_INVALID if the memory could not be mapped
+ *         or RBUF_POW2 is set and the rounded size is no power of two
+ */
+int ringbuffer_init_mirrored(rbctx_t *context, size_t buffer_size, int flags);
+
+/**
+ * Allocate a ringbuffer context and its memory. The memory is mapped
+ * separately from the heap, so it starts on a page (a cache line at least)
+ * and can be backed by huge pages, faulted in up front and bound to a NUMA
+ * node. Release both with ringbuffer_free.
+ *
+ * @param buffer_size size of the ringbuffer
+ * @param flags context flags, e.g. RBUF_VARINT | RBUF_HUGEPAGES | RBUF_PREFAULT, not RBUF_MIRRORED
+ * @param numa_node node the memory is bound to (0 up to the bits of an unsigned long), or RBUF_NUMA_ANY
+ * @return ringbuffer context, NULL if the memory could not be mapped or bound (errno EINVAL for other nodes),
+ *         or buffer_size and flags are invalid (see ringbuffer_init_flags)
+ */
+rbctx_t* ringbuffer_create(size_t buffer_size, int flags, int numa_node);
+
+/**
+ * Destroys a ringbuffer from ringbuffer_create and frees its context and memory.
+ *
+ * @param context ringbuffer context
+ */
+void ringbuffer_free(rbctx_t *context);
+
+/**
+ * Let writes that don't fit into the ringbuffer go to a spill file instead
+ * of waiting. Writes still go to memory whenever it has room, only the
+ * overflow is spilled. The file is a ring as well, space readers freed is
+ * reused right away. Every spilled message remembers how much was written
+ * to memory before it, so all read calls return the messages in write
+ * order transparently. A message larger than the memory can still be
+ * spilled, so ringbuffer_write_blocking takes messages up to the size of
+ * either. Zero-copy writes (ringbuffer_write_reserve) don't
+ * spill, they wait for room in memory. The file is unlinked right away and
+ * released by ringbuffer_destroy.
+ *
+ * @param context ringbuffer context, call before the ringbuffer is used
+ * @param dir directory the file is created in, e.g. "/var/tmp"
+ * @param spill_size bytes of the spill file, 24 bytes per message go to its header
+ * @return SUCCESS on success, RINGBUFFER_INVALID if the file could not be created or mapped,
+ *         the path would be longer than PATH_MAX or the ringbuffer already spills
+ */
+int ringbuffer_spill(rbctx_t *context, const char *dir, size_t spill_size);
+
 /**
  * Write to the ringbuffer.
  * 
  * @param context ringbuffer context
  * @param message The message to be placed in the ringbuffer
  * @param message_len size of the message
- * @return SUCESS on succes, RINGBUFFER_FULL when message doesn't fit
+ * @return SUCESS on succes, RINGBUFFER_FULL when message doesn't fit, RINGBUFFER_CLOSED after ringbuffer_close
  */
 int ringbuffer_write(rbctx_t *context, void *message, size_t message_len);
 
@@ -51,10 +208,291 @@ int ringbuffer_write(rbctx_t *context, void *message, size_t message_len);
  * @param context ringbuffer context
  * @param buffer reads to this location
  * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
- * @return SUCCESS on succes, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ * @return SUCCESS on succes, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL right away when
+ *         read message doesn't fit (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer),
+ *         RINGBUFFER_CLOSED once ringbuffer_close was called and all messages are read
  */
 int ringbuffer_read(rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
 
+/**
+ * Length of the next message without reading it or waiting for one,
+ * e.g. to size the buffer before ringbuffer_read. Only a snapshot, another
+ * reader may take the message first.
+ *
+ * @param context ringbuffer context
+ * @param message_len length of the next message is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if there is no message or it is peeked (ringbuffer_read_peek),
+ *         RINGBUFFER_CLOSED if closed and drained
+ */
+int ringbuffer_peek_len(rbctx_t *context, size_t *message_len);
+
+/**
+ * Write the concatenation of several buffers as one message, e.g. a header
+ * and a payload, without assembling them in a temporary buffer first.
+ * Waits like ringbuffer_write.
+ *
+ * @param context ringbuffer context
+ * @param iov the parts of the message in order
+ * @param iovcnt number of parts
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit, RINGBUFFER_CLOSED after ringbuffer_close
+ */
+int ringbuffer_writev(rbctx_t *context, const struct iovec *iov, int iovcnt);
+
+/**
+ * Read one message and scatter it over several buffers in order, e.g. a
+ * fixed size header into a struct and the payload into a data buffer.
+ * Waits like ringbuffer_read.
+ *
+ * @param context ringbuffer context
+ * @param iov the destinations, each one is filled before the next is used
+ * @param iovcnt number of destinations
+ * @param message_len size of the message received from the ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when the
+ *         message is larger than all destinations together (the message stays in the ringbuffer),
+ *         RINGBUFFER_CLOSED if closed and drained
+ */
+int ringbuffer_readv(rbctx_t *context, const struct iovec *iov, int iovcnt, size_t *message_len);
+
+/**
+ * Write to the ringbuffer, waiting as long as it takes for the message to fit.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_INVALID when the message is larger than the ringbuffer
+ *         and its spill file (see ringbuffer_spill), RINGBUFFER_CLOSED after ringbuffer_close
+ */
+int ringbuffer_write_blocking(rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer, waiting as long as it takes for a message to arrive.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer),
+ *         RINGBUFFER_CLOSED once ringbuffer_close was called and all messages are read
+ */
+int ringbuffer_read_blocking(rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Write to the ringbuffer without ever waiting.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit right now,
+ *         RINGBUFFER_CLOSED after ringbuffer_close
+ */
+int ringbuffer_try_write(rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer without ever waiting.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read right now, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer),
+ *         RINGBUFFER_CLOSED once ringbuffer_close was called and all messages are read
+ */
+int ringbuffer_try_read(rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Write to the ringbuffer, waiting for space until the deadline.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @param deadline_ns absolute CLOCK_MONOTONIC time in ns (see ringbuffer_now_ns), or RBUF_NO_WAIT/RBUF_WAIT_FOREVER
+ * @return SUCCESS on success, RINGBUFFER_FULL when message didn't fit before the deadline
+ */
+int ringbuffer_write_until(rbctx_t *context, void *message, size_t message_len, uint64_t deadline_ns);
+
+/**
+ * Read from the ringbuffer, waiting for a message until the deadline.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @param deadline_ns absolute CLOCK_MONOTONIC time in ns (see ringbuffer_now_ns), or RBUF_NO_WAIT/RBUF_WAIT_FOREVER
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no message arrived before the deadline, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int ringbuffer_read_until(rbctx_t *context, void *buffer, size_t *buffer_len_ptr, uint64_t deadline_ns);
+
+/**
+ * Current CLOCK_MONOTONIC time in ns, the clock of the *_until deadlines.
+ *
+ * @return time in ns
+ */
+uint64_t ringbuffer_now_ns(void);
+
+/**
+ * Write several messages with one lock acquisition and one wakeup.
+ * Waits like ringbuffer_write until the first message fits, then writes
+ * as many of the following messages as fit without waiting again.
+ *
+ * @param context ringbuffer context
+ * @param messages one iovec per message
+ * @param count number of messages
+ * @param nr_written number of messages written (a prefix of messages)
+ * @return SUCCESS if at least one message (or count is 0) was written, RINGBUFFER_FULL otherwise,
+ *         RINGBUFFER_CLOSED after ringbuffer_close
+ */
+int ringbuffer_write_batch(rbctx_t *context, const struct iovec *messages, size_t count, size_t *nr_written);
+
+/**
+ * Read several messages with one lock acquisition and one wakeup.
+ * Waits like ringbuffer_read for the first message, then drains messages
+ * until the ringbuffer is empty, max_messages are read or the next
+ * message doesn't fit into the rest of the buffer. The messages are
+ * stored back-to-back, message i is buffer[offsets[i]] to buffer[offsets[i + 1]].
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len size of the buffer
+ * @param offsets at least max_messages + 1 entries, offsets[0] is 0
+ * @param max_messages maximum number of messages to read
+ * @param nr_read number of messages read
+ * @return SUCCESS if at least one message was read, RINGBUFFER_EMPTY if no data to read,
+ *         OUTPUT_BUFFER_TOO_SMALL when the first message doesn't fit (it stays in the ringbuffer),
+ *         RINGBUFFER_CLOSED if closed and drained
+ */
+int ringbuffer_read_batch(rbctx_t *context, void *buffer, size_t buffer_len,
+                          size_t *offsets, size_t max_messages, size_t *nr_read);
+
+/**
+ * ringbuffer_read_batch, waiting for the first message until the deadline.
+ *
+ * @param deadline_ns absolute CLOCK_MONOTONIC time in ns (see ringbuffer_now_ns), or RBUF_NO_WAIT/RBUF_WAIT_FOREVER
+ * @return see ringbuffer_read_batch, RINGBUFFER_EMPTY if no message arrived before the deadline
+ */
+int ringbuffer_read_batch_until(rbctx_t *context, void *buffer, size_t buffer_len,
+                                size_t *offsets, size_t max_messages, size_t *nr_read, uint64_t deadline_ns);
+
+/**
+ * Reserve space for a message of up to max_len bytes and hand it out for
+ * the caller to fill in place (e.g. with fread). The space is given as up to
+ * two segments, the second one is only used when the message wraps around
+ * (never for mirrored ringbuffers). Other writers wait until the
+ * reservation is committed or aborted, readers are not affected.
+ *
+ * @param context ringbuffer context
+ * @param max_len maximum size of the message
+ * @param vec segments of the reserved space, vec[1].iov_len is 0 if not needed
+ * @return SUCCESS on success, RINGBUFFER_FULL when max_len bytes don't fit, RINGBUFFER_CLOSED after ringbuffer_close
+ */
+int ringbuffer_write_reserve(rbctx_t *context, size_t max_len, struct iovec vec[2]);
+
+/**
+ * Publish the message written into the space of ringbuffer_write_reserve.
+ *
+ * @param context ringbuffer context
+ * @param message_len size of the message, at most the reserved size
+ * @return SUCCESS on success, RINGBUFFER_INVALID without reservation or if message_len is too large
+ */
+int ringbuffer_write_commit(rbctx_t *context, size_t message_len);
+
+/**
+ * Drop the reservation of ringbuffer_write_reserve without writing a message.
+ *
+ * @param context ringbuffer context
+ */
+void ringbuffer_write_abort(rbctx_t *context);
+
+/**
+ * Hand out the next message without copying it. The message stays in the
+ * ringbuffer until ringbuffer_read_release, other readers wait meanwhile,
+ * so keep the peek short.
+ *
+ * @param context ringbuffer context
+ * @param vec segments of the message, vec[1].iov_len is 0 if it does not wrap around
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, RINGBUFFER_CLOSED if closed and drained
+ */
+int ringbuffer_read_peek(rbctx_t *context, struct iovec vec[2]);
+
+/**
+ * Remove the message handed out by ringbuffer_read_peek from the ringbuffer.
+ *
+ * @param context ringbuffer context
+ * @return SUCCESS on success, RINGBUFFER_INVALID without a peeked message
+ */
+int ringbuffer_read_release(rbctx_t *context);
+
+/**
+ * Descriptor that is readable while the ringbuffer holds messages, for
+ * poll/epoll loops. It is an eventfd the ringbuffer sets on the first
+ * message and clears when it runs empty, never read from it yourself.
+ *
+ * @param context ringbuffer context initialized with RBUF_EVENTFD
+ * @return file descriptor, -1 without RBUF_EVENTFD
+ */
+int ringbuffer_read_fd(rbctx_t *context);
+
+/**
+ * Descriptor that is readable while writes can succeed. It is cleared when
+ * a write finds the ringbuffer full and set again when a read makes room.
+ *
+ * @param context ringbuffer context initialized with RBUF_EVENTFD
+ * @return file descriptor, -1 without RBUF_EVENTFD
+ */
+int ringbuffer_write_fd(rbctx_t *context);
+
+/**
+ * Wait until any of the ringbuffers holds a message. Another reader may
+ * take it first, so read with ringbuffer_try_read and poll again on RINGBUFFER_EMPTY.
+ *
+ * @param contexts ringbuffer contexts initialized with RBUF_EVENTFD
+ * @param count number of contexts, at least 1
+ * @param ready index of the first ringbuffer with a message
+ * @param deadline_ns absolute CLOCK_MONOTONIC time in ns (see ringbuffer_now_ns), or RBUF_NO_WAIT/RBUF_WAIT_FOREVER
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if all stayed empty until the deadline,
+ *         RINGBUFFER_INVALID if count is 0, a ringbuffer has no RBUF_EVENTFD or poll fails
+ */
+int ringbuffer_poll(rbctx_t **contexts, size_t count, size_t *ready, uint64_t deadline_ns);
+
+/**
+ * Close the ringbuffer for shutdown. All waiting readers and writers wake
+ * up, writes fail from now on, reads still return the stored messages and
+ * RINGBUFFER_CLOSED once none are left. A reservation of
+ * ringbuffer_write_reserve can still be committed, readers wait for its
+ * commit or abort before they return RINGBUFFER_CLOSED. The read_fd of
+ * RBUF_EVENTFD stays readable, so poll loops see the close as well.
+ * Closing is final, the ringbuffer still has to be destroyed.
+ *
+ * @param context ringbuffer context
+ */
+void ringbuffer_close(rbctx_t *context);
+
+/**
+ * Bytes currently stored in the ringbuffer, length prefixes included.
+ * Only a snapshot, other threads may change it right after the call.
+ *
+ * @param context ringbuffer context
+ * @return number of used bytes
+ */
+size_t ringbuffer_used(rbctx_t *context);
+
+/**
+ * Copy the statistics counters of the ringbuffer, e.g. to size it from the high-water mark.
+ *
+ * @param context ringbuffer context
+ * @param stats receives the counters since initialization
+ */
+void ringbuffer_stats(rbctx_t *context, rbstats_t *stats);
+
+/**
+ * Percentiles of the time between writing and reading the messages read so far.
+ * Values are the upper end of their histogram bucket, at most 12.5% above the exact value.
+ *
+ * @param context ringbuffer context
+ * @param latency receives count, p50, p99, p99.9 and max in ns
+ * @return SUCCESS on success, RINGBUFFER_INVALID if the ringbuffer was not initialized with RBUF_TIMESTAMPS
+ */
+int ringbuffer_latency(rbctx_t *context, rblatency_t *latency);
+
 /**
  * Frees all memory allocated and syncronization variables created during initialization.
  * 
@@ -62,4 +500,8 @@ int ringbuffer_read(rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
  */
 void ringbuffer_destroy(rbctx_t *context);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif //RINGBUF_H
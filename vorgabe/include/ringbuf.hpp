@@ -0,0 +1,217 @@
+#ifndef RINGBUF_HPP
+#define RINGBUF_HPP
+
+/*
+ * C++20 wrappers around rbctx_t, header-only. The C functions do the work,
+ * so messages use the same framing (RBUF_VARINT) and native() can be handed
+ * to C code on the other end. Sizes are template parameters: MaxMsg is
+ * checked at compile time and a power-of-two Capacity selects RBUF_POW2.
+ */
+
+#include "ringbuf.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ringbuf {
+
+//bytes of the RBUF_VARINT prefix in front of a message of len bytes
+constexpr std::size_t varint_len(std::size_t len)
+{
+    std::size_t width = 1;
+    while (len >= 0x80) {
+        len >>= 7;
+        width++;
+    }
+    return width;
+}
+
+constexpr std::size_t next_pow2(std::size_t n)
+{
+    std::size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/**
+ * Ringbuffer of messages of up to MaxMsg bytes in Capacity bytes of memory.
+ * Move-only, the memory is allocated once by the constructor and released
+ * by the destructor. Reads and writes never allocate.
+ *
+ * @tparam Capacity bytes of ring memory
+ * @tparam MaxMsg largest message, its prefix included it has to fit into the ring
+ */
+template <std::size_t Capacity, std::size_t MaxMsg = Capacity / 2>
+class ByteRing {
+public:
+    static constexpr bool pow2 = Capacity != 0 && (Capacity & (Capacity - 1)) == 0;
+    static constexpr std::size_t capacity = Capacity;
+    static constexpr std::size_t max_message = MaxMsg;
+    static constexpr int flags = RBUF_VARINT | (pow2 ? RBUF_POW2 : 0);
+
+    static_assert(Capacity >= 2, "a ringbuffer needs at least 2 bytes");
+    static_assert(MaxMsg > 0 && varint_len(MaxMsg) + MaxMsg <= (pow2 ? Capacity : Capacity - 1),
+                  "MaxMsg and its length prefix don't fit into Capacity");
+
+    /**
+     * @param extra_flags further context flags, e.g. RBUF_TIMESTAMPS or a wait strategy
+     * @throws std::invalid_argument if ringbuffer_init_flags rejects the flags: both wait
+     *         strategies, or RBUF_POW2 while Capacity is no power of two
+     * @throws std::bad_alloc if the memory, the RBUF_TIMESTAMPS histogram or the RBUF_EVENTFD
+     *         fds could not be allocated
+     */
+    explicit ByteRing(int extra_flags = 0)
+    {
+        //ringbuffer_init_flags returns RINGBUFFER_INVALID for both, so the flags are checked first
+        int all = flags | extra_flags;
+        if (((all & RBUF_POW2) && !pow2) || ((all & RBUF_WAIT_SPIN) && (all & RBUF_WAIT_BACKOFF))) {
+            throw std::invalid_argument("ringbuf::ByteRing: invalid flags");
+        }
+        state_.reset(new State);
+        if (ringbuffer_init_flags(&state_->ctx, state_->memory, Capacity, all) != SUCCESS) {
+            state_.reset();
+            throw std::bad_alloc();
+        }
+        state_->initialized = true;
+    }
+
+    ByteRing(ByteRing &&) noexcept = default;
+    ByteRing &operator=(ByteRing &&) noexcept = default;
+    ByteRing(const ByteRing &) = delete;
+    ByteRing &operator=(const ByteRing &) = delete;
+
+    /**
+     * Write a message, waiting like ringbuffer_write.
+     *
+     * @return SUCCESS, RINGBUFFER_FULL or RINGBUFFER_INVALID for more than MaxMsg bytes
+     */
+    int write(std::span<const std::byte> message)
+    {
+        if (message.size() > MaxMsg) {
+            return RINGBUFFER_INVALID;
+        }
+        return ringbuffer_write(native(), const_cast<std::byte *>(message.data()), message.size());
+    }
+
+    /**
+     * Write a message if there is room right now, see ringbuffer_try_write.
+     */
+    int try_write(std::span<const std::byte> message)
+    {
+        if (message.size() > MaxMsg) {
+            return RINGBUFFER_INVALID;
+        }
+        return ringbuffer_try_write(native(), const_cast<std::byte *>(message.data()), message.size());
+    }
+
+    /**
+     * Read a message into buffer, waiting like ringbuffer_read.
+     *
+     * @param message_len length of the message read, or the required size on OUTPUT_BUFFER_TOO_SMALL
+     * @return SUCCESS, RINGBUFFER_EMPTY or OUTPUT_BUFFER_TOO_SMALL
+     */
+    int read(std::span<std::byte> buffer, std::size_t &message_len)
+    {
+        message_len = buffer.size();
+        return ringbuffer_read(native(), buffer.data(), &message_len);
+    }
+
+    /**
+     * Read a message if there is one right now, see ringbuffer_try_read.
+     */
+    int try_read(std::span<std::byte> buffer, std::size_t &message_len)
+    {
+        message_len = buffer.size();
+        return ringbuffer_try_read(native(), buffer.data(), &message_len);
+    }
+
+    std::size_t used() { return ringbuffer_used(native()); }
+
+    //the C context, for C code on the other end or calls without a wrapper
+    rbctx_t *native() { return &state_->ctx; }
+
+private:
+    struct State {
+        rbctx_t ctx;
+        alignas(RBUF_CACHELINE) std::byte memory[Capacity];
+        bool initialized = false;
+
+        ~State()
+        {
+            if (initialized) {
+                ringbuffer_destroy(&ctx);
+            }
+        }
+    };
+
+    //allocated once although the size is known: the context holds the mutex and points
+    //into memory, neither may change its address when the ring is moved
+    std::unique_ptr<State> state_;
+};
+
+/**
+ * Ringbuffer of at least Capacity values of T, each one message of
+ * sizeof(T) bytes. Move-only like ByteRing.
+ *
+ * @tparam T trivially copyable element type
+ * @tparam Capacity number of elements it holds at least
+ */
+template <typename T, std::size_t Capacity>
+class Ringbuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "elements are copied as bytes");
+    static_assert(Capacity > 0, "a ringbuffer needs room for one element");
+
+    static constexpr std::size_t frame = varint_len(sizeof(T)) + sizeof(T);
+    using Ring = ByteRing<next_pow2(Capacity * frame), sizeof(T)>;
+
+public:
+    static constexpr std::size_t capacity = Ring::capacity / frame;
+
+    /**
+     * @param extra_flags further context flags, see ByteRing
+     * @throws std::invalid_argument or std::bad_alloc like ByteRing
+     */
+    explicit Ringbuffer(int extra_flags = 0) : ring_(extra_flags) {}
+
+    /**
+     * @return SUCCESS or RINGBUFFER_FULL, waiting like ringbuffer_write
+     */
+    int push(const T &value)
+    {
+        return ring_.write(std::as_bytes(std::span<const T, 1>(&value, 1)));
+    }
+
+    /**
+     * @return the oldest element, nothing if the ringbuffer stayed empty, waiting like ringbuffer_read
+     */
+    std::optional<T> pop()
+    {
+        std::array<std::byte, sizeof(T)> buffer;
+        std::size_t len;
+        if (ring_.read(buffer, len) != SUCCESS) {
+            return std::nullopt;
+        }
+        //no default constructed T to copy into, T only has to be trivially copyable
+        return std::bit_cast<T>(buffer);
+    }
+
+    std::size_t size() { return ring_.used() / frame; }
+
+    rbctx_t *native() { return ring_.native(); }
+
+private:
+    Ring ring_;
+};
+
+} // namespace ringbuf
+
+#endif //RINGBUF_HPP
@@ -0,0 +1,83 @@
+#ifndef RINGBUF_BCAST_H
+#define RINGBUF_BCAST_H
+
+#include "ringbuf.h"
+
+/* what a write does when the slowest subscriber hasn't made room yet */
+typedef enum {
+    RBUF_BCAST_GATED = 0,   /* wait like ringbuffer_write, RINGBUFFER_FULL after RBUF_TIMEOUT */
+    RBUF_BCAST_OVERWRITE,   /* drop the oldest messages of the lagging subscribers, see bcast_ringbuffer_lag */
+} rbcast_mode_t;
+
+/*
+ * One writer, several subscribers that each read every message at their own
+ * pace. The messages are framed like in rbctx_t (same flags, same prefix),
+ * every subscriber has its own read cursor and a message is only freed when
+ * the slowest subscriber has read it.
+ */
+typedef struct {
+    rbctx_t ring;           //memory, framing and synchronization, ring.head counts the written bytes
+    uint64_t* cursors;      //bytes each subscriber has read
+    uint64_t* lost;         //messages each subscriber missed because they were overwritten
+    size_t nr_subscribers;
+    rbcast_mode_t mode;
+} bcast_rbctx_t;
+
+/**
+ * Initialize a broadcast ringbuffer.
+ * Generate ringbuffer context and memory before initialization.
+ *
+ * @param context ringbuffer context
+ * @param buffer_location the first byte location of the ringbuffer in memory
+ * @param buffer_size size of the ringbuffer (and memory)
+ * @param flags context flags, e.g. RBUF_VARINT, see ringbuffer_init_flags. RBUF_EVENTFD and
+ *              RBUF_TIMESTAMPS are not supported
+ * @param nr_subscribers number of subscribers, they are numbered from 0
+ * @param mode whether the writer waits for or overwrites the slowest subscriber
+ * @return SUCCESS on success, RINGBUFFER_INVALID if there are no subscribers, flags
+ *         are invalid for buffer_size or unsupported, or the cursors could not be allocated
+ */
+int bcast_ringbuffer_init(bcast_rbctx_t *context, void *buffer_location, size_t buffer_size, int flags,
+                          size_t nr_subscribers, rbcast_mode_t mode);
+
+/**
+ * Write a message for all subscribers.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when the slowest subscriber didn't make room in time
+ *         (RBUF_BCAST_GATED only), RINGBUFFER_INVALID when the message is larger than the ringbuffer
+ */
+int bcast_ringbuffer_write(bcast_rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read the next message of a subscriber, waiting like ringbuffer_read.
+ *
+ * @param context ringbuffer context
+ * @param subscriber number of the subscriber
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int bcast_ringbuffer_read(bcast_rbctx_t *context, size_t subscriber, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * How far a subscriber is behind the writer.
+ *
+ * @param context ringbuffer context
+ * @param subscriber number of the subscriber
+ * @param behind bytes written but not read yet by the subscriber, length prefixes included
+ * @param lost messages the subscriber never saw because they were overwritten
+ */
+void bcast_ringbuffer_lag(bcast_rbctx_t *context, size_t subscriber, uint64_t *behind, uint64_t *lost);
+
+/**
+ * Frees the cursors and the synchronization variables.
+ *
+ * @param context ringbuffer context
+ */
+void bcast_ringbuffer_destroy(bcast_rbctx_t *context);
+
+#endif //RINGBUF_BCAST_H
@@ -0,0 +1,86 @@
+#ifndef RINGBUF_ELASTIC_H
+#define RINGBUF_ELASTIC_H
+
+#include "ringbuf.h"
+
+/*
+ * Ringbuffer that grows when a message doesn't fit and shrinks when it
+ * runs empty with little use. Nothing is ever copied on a resize: writers
+ * switch to a new ring right away and readers drain the older rings before
+ * they continue with the new one. Rings are rbctx_t for memory and framing
+ * only, they have no mutexes or conditions of their own.
+ */
+typedef struct elastic_ring elastic_ring_t;
+
+typedef struct {
+    elastic_ring_t* oldest;     //readers read here, list of rings up to newest
+    elastic_ring_t* newest;     //writers write here
+    size_t min_size;
+    size_t max_size;
+    int flags;          //framing flags of the rings
+    size_t peak;        //most bytes stored in newest since it last ran empty
+    rbctx_t sync;       //no memory: the mutex, conditions, RBUF_WAIT_* strategy and stats of all rings
+} elastic_rbctx_t;
+
+/**
+ * Initialize an elastic ringbuffer. The rings are allocated by the
+ * ringbuffer and released by elastic_ringbuffer_destroy.
+ *
+ * @param context ringbuffer context
+ * @param min_size size of the first ring and the smallest it shrinks to
+ * @param max_size the largest it grows to, the size doubles on every step
+ * @param flags RBUF_VARINT and RBUF_POW2 for the framing of the rings, RBUF_WAIT_SPIN or
+ *              RBUF_WAIT_BACKOFF for the blocking calls, see ringbuffer_init_flags
+ * @return SUCCESS on success, RINGBUFFER_INVALID if min_size is 0 or above max_size, other flags
+ *         are set, RBUF_POW2 is set and min_size or max_size is no power of two, or the ring
+ *         could not be allocated
+ */
+int elastic_ringbuffer_init(elastic_rbctx_t *context, size_t min_size, size_t max_size, int flags);
+
+/**
+ * Write to the ringbuffer, growing it when the message doesn't fit.
+ * Once the ringbuffer can't grow any further it waits like ringbuffer_write.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit,
+ *         RINGBUFFER_INVALID when the message is larger than max_size allows
+ */
+int elastic_ringbuffer_write(elastic_rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer, waiting like ringbuffer_read.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int elastic_ringbuffer_read(elastic_rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Current size of the ring writers write to.
+ *
+ * @param context ringbuffer context
+ * @return size in bytes
+ */
+size_t elastic_ringbuffer_size(elastic_rbctx_t *context);
+
+/**
+ * Counters of all rings since initialization, see ringbuffer_stats.
+ *
+ * @param context ringbuffer context
+ * @param stats receives the counters
+ */
+void elastic_ringbuffer_stats(elastic_rbctx_t *context, rbstats_t *stats);
+
+/**
+ * Frees the rings and the synchronization variables.
+ *
+ * @param context ringbuffer context
+ */
+void elastic_ringbuffer_destroy(elastic_rbctx_t *context);
+
+#endif //RINGBUF_ELASTIC_H
@@ -0,0 +1,97 @@
+#ifndef RINGBUF_GROUP_H
+#define RINGBUF_GROUP_H
+
+#include <stdatomic.h>
+
+#include "ringbuf.h"
+
+/* which lane a group read looks at first */
+typedef enum {
+    RBUF_GROUP_ROUND_ROBIN = 0, /* every read starts one lane further */
+    RBUF_GROUP_OCCUPANCY,       /* the lane with the most bytes stored */
+} rbgroup_policy_t;
+
+/*
+ * A group of independent ringbuffers (lanes) that share the consumers.
+ * Every producer writes to its own lane with the usual ringbuffer_* calls,
+ * so producers on different lanes never contend for the same mutex.
+ * Consumers read from the whole group, messages of one lane stay in order,
+ * there is no order between lanes.
+ */
+typedef struct {
+    rbctx_t* lanes;
+    size_t nr_lanes;
+    rbgroup_policy_t policy;
+    _Atomic size_t next;    //lane the next round-robin read starts at
+    void* memory;           //nr_lanes * lane_size bytes, owned by the group
+    struct rbbell* bell;    //readers of an empty group park here, every lane rings it
+} rbgroup_t;
+
+/**
+ * Initialize a ringbuffer group. The lanes and their memory are allocated
+ * by the group and released by ringbuffer_group_destroy.
+ *
+ * @param group ringbuffer group
+ * @param nr_lanes number of lanes, e.g. one per producer
+ * @param lane_size size of every lane, at least one message of 1 byte with its prefix has to fit
+ * @param flags context flags of every lane, see ringbuffer_init_flags
+ * @param policy which lane a read looks at first
+ * @return SUCCESS on success, RINGBUFFER_INVALID if nr_lanes is 0, lane_size is too small, a lane
+ *         can't be initialized with flags or the memory could not be allocated
+ */
+int ringbuffer_group_init(rbgroup_t *group, size_t nr_lanes, size_t lane_size, int flags, rbgroup_policy_t policy);
+
+/**
+ * Lane of a producer. Write to it with ringbuffer_write, ringbuffer_write_reserve, ...
+ *
+ * @param group ringbuffer group
+ * @param producer any number identifying the producer, lanes are assigned modulo nr_lanes
+ * @return ringbuffer context of the lane
+ */
+rbctx_t* ringbuffer_group_lane(rbgroup_t *group, size_t producer);
+
+/**
+ * Close all lanes, see ringbuffer_close. Producers can also close their
+ * own lane, readers see RINGBUFFER_CLOSED once every lane is closed and drained.
+ *
+ * @param group ringbuffer group
+ */
+void ringbuffer_group_close(rbgroup_t *group);
+
+/**
+ * Read one message from any lane. Waits like ringbuffer_read when all lanes are empty.
+ *
+ * @param group ringbuffer group
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in its lane),
+ *         RINGBUFFER_CLOSED once all lanes are closed and drained
+ */
+int ringbuffer_group_read(rbgroup_t *group, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Read several messages of one lane, see ringbuffer_read_batch.
+ * Waits like ringbuffer_read_batch when all lanes are empty.
+ *
+ * @param group ringbuffer group
+ * @param buffer reads to this location
+ * @param buffer_len size of the buffer
+ * @param offsets at least max_messages + 1 entries, offsets[0] is 0
+ * @param max_messages maximum number of messages to read
+ * @param nr_read number of messages read
+ * @return SUCCESS if at least one message was read, RINGBUFFER_EMPTY if no data to read,
+ *         OUTPUT_BUFFER_TOO_SMALL when the first message doesn't fit (it stays in its lane),
+ *         RINGBUFFER_CLOSED once all lanes are closed and drained
+ */
+int ringbuffer_group_read_batch(rbgroup_t *group, void *buffer, size_t buffer_len,
+                                size_t *offsets, size_t max_messages, size_t *nr_read);
+
+/**
+ * Destroy all lanes and free the memory of the group.
+ *
+ * @param group ringbuffer group
+ */
+void ringbuffer_group_destroy(rbgroup_t *group);
+
+#endif //RINGBUF_GROUP_H
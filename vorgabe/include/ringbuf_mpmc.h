@@ -0,0 +1,70 @@
+#ifndef RINGBUF_MPMC_H
+#define RINGBUF_MPMC_H
+
+#include <stdatomic.h>
+
+#include "ringbuf.h"
+
+/*
+ * Multi-producer/multi-consumer ring of fixed size slots.
+ * Every slot carries a sequence number that tells producers and consumers
+ * whether it is free or filled for their ticket, so neither side needs a
+ * shared lock: a producer claims a ticket with a CAS on enqueue_pos, fills the
+ * slot and publishes it by bumping the slot's sequence (and vice versa for
+ * consumers on dequeue_pos).
+ */
+typedef struct {
+    _Alignas(RBUF_CACHELINE) _Atomic size_t enqueue_pos;
+    _Alignas(RBUF_CACHELINE) _Atomic size_t dequeue_pos;
+
+    /* constant after initialization */
+    _Alignas(RBUF_CACHELINE) uint8_t* slots;
+    size_t mask;        // number of slots - 1
+    size_t slot_size;   // maximum message length
+    size_t stride;      // bytes per slot including its header
+} mpmc_rbctx_t;
+
+/**
+ * Initialize a multi-producer/multi-consumer ringbuffer.
+ * Generate ringbuffer context and memory before initialization. The memory
+ * is divided into a power of two number of slots that each hold one message
+ * of up to max_message_len bytes.
+ *
+ * @param context ringbuffer context
+ * @param buffer_location the first byte location of the ringbuffer in memory (8 byte aligned)
+ * @param buffer_size size of the ringbuffer (and memory)
+ * @param max_message_len largest message that will be written, e.g. MESSAGE_SIZE
+ * @return SUCCESS on success, RINGBUFFER_INVALID when the memory holds less than two slots
+ */
+int mpmc_ringbuffer_init(mpmc_rbctx_t *context, void *buffer_location, size_t buffer_size, size_t max_message_len);
+
+/**
+ * Write to the ringbuffer. Never blocks.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when all slots are taken,
+ *         RINGBUFFER_INVALID when message_len is larger than a slot
+ */
+int mpmc_ringbuffer_write(mpmc_rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer. Never blocks.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int mpmc_ringbuffer_read(mpmc_rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Destroy the ringbuffer context. The memory is owned by the caller.
+ *
+ * @param context ringbuffer context
+ */
+void mpmc_ringbuffer_destroy(mpmc_rbctx_t *context);
+
+#endif //RINGBUF_MPMC_H
@@ -0,0 +1,86 @@
+#ifndef RINGBUF_PERSIST_H
+#define RINGBUF_PERSIST_H
+
+#include "ringbuf.h"
+
+#define RBUF_PERSIST_MAGIC 0x5242504552534931ull   /* "RBPERSI1", a new file gets its name only after the header is synced */
+
+/*
+ * Header in the first page of the file, the message memory follows on
+ * the next page. head only moves after the bytes of a message are in the
+ * file and tail only after a message was copied out, so after a crash
+ * everything between tail and head is complete and was not consumed yet.
+ * A message that was read but whose tail didn't make it into the file is
+ * delivered again (at least once).
+ */
+typedef struct {
+    uint64_t magic;
+    uint64_t size;      //bytes of message memory
+    uint64_t flags;     //framing flags (RBUF_VARINT, RBUF_POW2) the messages were written with
+    uint64_t head;      //bytes ever committed
+    uint64_t tail;      //bytes ever consumed
+} persist_rbhdr_t;
+
+/*
+ * Ringbuffer whose messages and cursors live in a mapped file. The rbctx_t
+ * runs on the mapped message memory and its mutex serializes the threads
+ * of this process, an exclusive flock keeps other processes out.
+ */
+typedef struct {
+    rbctx_t ring;
+    persist_rbhdr_t* hdr;
+    size_t map_len;
+    size_t page;
+    int durable;        //msync the message before head and head before returning
+    int fd;             //holds the flock until persist_ringbuffer_close
+} persist_rbctx_t;
+
+/**
+ * Open the persistent ringbuffer in path, creating the file if it doesn't
+ * exist. A new file is prepared under a temporary name next to path and
+ * appears under path only with a complete header. An existing file is
+ * recovered: every message that was committed and not consumed before the
+ * last close or crash is read again. The file is locked with flock until
+ * persist_ringbuffer_close.
+ *
+ * @param context ringbuffer context
+ * @param path file of the ringbuffer
+ * @param buffer_size bytes of message memory, must match an existing file
+ * @param flags RBUF_VARINT and RBUF_POW2 only, must match an existing file
+ * @param durable nonzero to msync every commit in order, surviving power loss and not only a crash of the process
+ * @return SUCCESS on success, RINGBUFFER_INVALID if the file can't be opened, locked or mapped (another
+ *         process has it open), or an existing file has another size, other flags or a broken header
+ */
+int persist_ringbuffer_open(persist_rbctx_t *context, const char *path, size_t buffer_size, int flags, int durable);
+
+/**
+ * Write to the ringbuffer, waiting like ringbuffer_write. The message
+ * survives a crash once this returned SUCCESS.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit
+ */
+int persist_ringbuffer_write(persist_rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer, waiting like ringbuffer_read. The message is
+ * consumed in the file once this returned SUCCESS.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int persist_ringbuffer_read(persist_rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Unmap and unlock the file, it keeps all messages that were not read.
+ *
+ * @param context ringbuffer context
+ */
+void persist_ringbuffer_close(persist_rbctx_t *context);
+
+#endif //RINGBUF_PERSIST_H
@@ -0,0 +1,85 @@
+#ifndef RINGBUF_PRIO_H
+#define RINGBUF_PRIO_H
+
+#include "ringbuf.h"
+
+/* which lane a read serves when several have messages */
+typedef enum {
+    RBUF_PRIO_STRICT = 0,   /* always the lowest lane number, lane 0 is the highest priority */
+    RBUF_PRIO_WEIGHTED,     /* lanes in proportion to their weights (smooth weighted round-robin) */
+} rbprio_policy_t;
+
+/*
+ * Ringbuffer with one lane per priority class behind a single mutex.
+ * Every lane has its own memory, so bulk traffic filling its lane never
+ * takes space from another class. The lanes are rbctx_t for memory and
+ * framing only, they have no mutexes or conditions of their own.
+ */
+typedef struct {
+    rbctx_t* lanes;
+    unsigned* weights;      //RBUF_PRIO_WEIGHTED only
+    long* credits;          //RBUF_PRIO_WEIGHTED only
+    size_t nr_lanes;
+    rbprio_policy_t policy;
+    rbctx_t sync;           //no memory: the mutex, conditions, RBUF_WAIT_* strategy and stats of all lanes
+} prio_rbctx_t;
+
+/**
+ * Initialize a priority ringbuffer.
+ * Generate ringbuffer context and memory before initialization. The memory
+ * is split into the lanes in order.
+ *
+ * @param context ringbuffer context
+ * @param buffer_location the first byte location of the ringbuffer in memory
+ * @param lane_sizes size of every lane, the memory holds their sum
+ * @param weights share of reads of every lane for RBUF_PRIO_WEIGHTED (at least 1), NULL for RBUF_PRIO_STRICT
+ * @param nr_lanes number of priority classes
+ * @param flags RBUF_VARINT and RBUF_POW2 for the framing of the lanes, RBUF_WAIT_SPIN or
+ *              RBUF_WAIT_BACKOFF for the blocking calls, see ringbuffer_init_flags
+ * @param policy how reads pick a lane
+ * @return SUCCESS on success, RINGBUFFER_INVALID if there are no lanes, weights are missing
+ *         or zero, flags are invalid or unsupported for a lane size or the lanes could not be allocated
+ */
+int prio_ringbuffer_init(prio_rbctx_t *context, void *buffer_location, const size_t *lane_sizes,
+                         const unsigned *weights, size_t nr_lanes, int flags, rbprio_policy_t policy);
+
+/**
+ * Write to the lane of a priority class, waiting like ringbuffer_write for space in that lane.
+ *
+ * @param context ringbuffer context
+ * @param prio priority class, the lane number
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit into the lane,
+ *         RINGBUFFER_INVALID if there is no such lane
+ */
+int prio_ringbuffer_write(prio_rbctx_t *context, size_t prio, void *message, size_t message_len);
+
+/**
+ * Read the next message by the policy, waiting like ringbuffer_read while all lanes are empty.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @param prio priority class of the message is stored here, may be NULL
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int prio_ringbuffer_read(prio_rbctx_t *context, void *buffer, size_t *buffer_len_ptr, size_t *prio);
+
+/**
+ * Counters of all lanes since initialization, see ringbuffer_stats.
+ *
+ * @param context ringbuffer context
+ * @param stats receives the counters
+ */
+void prio_ringbuffer_stats(prio_rbctx_t *context, rbstats_t *stats);
+
+/**
+ * Frees the lanes and the synchronization variables.
+ *
+ * @param context ringbuffer context
+ */
+void prio_ringbuffer_destroy(prio_rbctx_t *context);
+
+#endif //RINGBUF_PRIO_H
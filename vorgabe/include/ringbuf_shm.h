@@ -0,0 +1,97 @@
+#ifndef RINGBUF_SHM_H
+#define RINGBUF_SHM_H
+
+#include "ringbuf.h"
+
+#define RBUF_SHM_MAGIC 0x52425348u  /* "RBSH", marks an initialized control block */
+
+/* how long one wait lasts before the state is checked again, a waiter that
+ * died inside the condition must not swallow the wakeup of a live one */
+#define RBUF_SHM_POLL_NS 10000000
+
+/*
+ * Control block at the start of the shared mapping, the message memory
+ * follows it. Everything in here is shared between the processes, so it
+ * only holds offsets (head/tail) and no pointers.
+ * The mutex is robust: when a process dies while holding it the next
+ * locker takes over. head and tail only move after a message is copied
+ * completely, so a half written message of a dead producer is never seen.
+ */
+typedef struct {
+    uint32_t magic;
+    size_t size;                //bytes of message memory
+    pthread_mutex_t mtx;        //process-shared, robust
+    pthread_cond_t not_empty;   //process-shared, CLOCK_MONOTONIC
+    pthread_cond_t not_full;
+    uint64_t head;              //bytes ever written
+    uint64_t tail;              //bytes ever read
+} shm_rbctrl_t;
+
+/* per process view of the shared ringbuffer */
+typedef struct {
+    shm_rbctrl_t* ctrl;
+    uint8_t* begin;     //message memory in this process
+    size_t map_len;
+    int owner;          //created it, unlinks it on destroy
+    char name[64];
+} shm_rbctx_t;
+
+/**
+ * Create a ringbuffer in the POSIX shared memory object name and map it.
+ * Other processes attach with shm_ringbuffer_open.
+ *
+ * @param context ringbuffer context of this process
+ * @param name shared memory object name, e.g. "/simpledaemon"
+ * @param buffer_size bytes of message memory
+ * @return SUCCESS on success, RINGBUFFER_INVALID if the object exists already or can't be created
+ */
+int shm_ringbuffer_create(shm_rbctx_t *context, const char *name, size_t buffer_size);
+
+/**
+ * Attach to a ringbuffer created by shm_ringbuffer_create in another process.
+ *
+ * @param context ringbuffer context of this process
+ * @param name shared memory object name
+ * @return SUCCESS on success, RINGBUFFER_INVALID if there is no initialized ringbuffer of that name
+ */
+int shm_ringbuffer_open(shm_rbctx_t *context, const char *name);
+
+/**
+ * Write to the ringbuffer, waiting up to RBUF_TIMEOUT for space.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit,
+ *         RINGBUFFER_INVALID when the mutex can't be recovered
+ */
+int shm_ringbuffer_write(shm_rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer, waiting up to RBUF_TIMEOUT for a message.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer),
+ *         RINGBUFFER_INVALID when the mutex can't be recovered
+ */
+int shm_ringbuffer_read(shm_rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Detach this process from the ringbuffer.
+ *
+ * @param context ringbuffer context
+ */
+void shm_ringbuffer_close(shm_rbctx_t *context);
+
+/**
+ * Detach and, in the creating process, destroy the synchronization and
+ * unlink the shared memory object. Processes still attached keep their mapping.
+ *
+ * @param context ringbuffer context
+ */
+void shm_ringbuffer_destroy(shm_rbctx_t *context);
+
+#endif //RINGBUF_SHM_H
@@ -0,0 +1,71 @@
+#ifndef RINGBUF_SPSC_H
+#define RINGBUF_SPSC_H
+
+#include <stdatomic.h>
+
+#include "ringbuf.h"
+
+/*
+ * Single-producer/single-consumer variant of the ringbuffer.
+ * Uses the same length-prefixed framing and return codes as rbctx_t, but no
+ * mutex: the producer only stores `write`, the consumer only stores `read`.
+ * Each side keeps a cached copy of the opposite index and only reloads it
+ * (with acquire ordering) when the cached value says the ring is full/empty.
+ */
+typedef struct {
+    /* producer owned */
+    _Alignas(RBUF_CACHELINE) _Atomic size_t write;
+    size_t read_cache;
+
+    /* consumer owned */
+    _Alignas(RBUF_CACHELINE) _Atomic size_t read;
+    size_t write_cache;
+
+    /* constant after initialization */
+    _Alignas(RBUF_CACHELINE) uint8_t* begin;
+    size_t size;
+} spsc_rbctx_t;
+
+/**
+ * Initialize a single-producer/single-consumer ringbuffer.
+ * Generate ringbuffer context and memory before initialization.
+ * The context should be allocated with at least RBUF_CACHELINE alignment
+ * (e.g. aligned_alloc) to keep both indices on separate cache lines.
+ *
+ * @param context ringbuffer context
+ * @param buffer_location the first byte location of the ringbuffer in memory
+ * @param buffer_size size of the ringbuffer (and memory)
+ */
+void spsc_ringbuffer_init(spsc_rbctx_t *context, void *buffer_location, size_t buffer_size);
+
+/**
+ * Write to the ringbuffer. Must only be called from the producer thread.
+ * Never blocks.
+ *
+ * @param context ringbuffer context
+ * @param message The message to be placed in the ringbuffer
+ * @param message_len size of the message
+ * @return SUCCESS on success, RINGBUFFER_FULL when message doesn't fit
+ */
+int spsc_ringbuffer_write(spsc_rbctx_t *context, void *message, size_t message_len);
+
+/**
+ * Read from the ringbuffer. Must only be called from the consumer thread.
+ * Never blocks.
+ *
+ * @param context ringbuffer context
+ * @param buffer reads to this location
+ * @param buffer_len_ptr size of the message buffer. Size of message received from ringbuffer is stored here
+ * @return SUCCESS on success, RINGBUFFER_EMPTY if no data to read, OUTPUT_BUFFER_TOO_SMALL when read message doesn't fit
+ *         (the required size is stored in buffer_len_ptr and the message stays in the ringbuffer)
+ */
+int spsc_ringbuffer_read(spsc_rbctx_t *context, void *buffer, size_t *buffer_len_ptr);
+
+/**
+ * Destroy the ringbuffer context. The memory is owned by the caller.
+ *
+ * @param context ringbuffer context
+ */
+void spsc_ringbuffer_destroy(spsc_rbctx_t *context);
+
+#endif //RINGBUF_SPSC_H
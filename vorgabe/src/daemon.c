@@ -6,6 +6,180 @@
 
 #include "../include/daemon.h"
 #include "../include/ringbuf.h"
+#include "../include/ringbuf_mpmc.h"
+#include "../include/ringbuf_group.h"
+#include "../include/ringbuf_shm.h"
+#include "../include/ringbuf_elastic.h"
+
+#define READ_BATCH 8    /* packets a processing thread takes from the ring at once */
+
+/* ring implementation selected by daemon_options_t, kind tells which member is used */
+typedef struct {
+    daemon_ring_t kind;
+    union {
+        rbctx_t rb;
+        mpmc_rbctx_t mpmc;
+        rbgroup_t group;
+        shm_rbctx_t shm;
+        elastic_rbctx_t elastic;
+    };
+    int spill;          /* DAEMON_RING_LOCKED with a spill file */
+    int writers_done;   /* rings without ringbuffer_close, see ring_close */
+} ring_t;
+
+/* rings that only copy whole messages in and out, reservations don't spill */
+static int ring_staged(ring_t* ring) {
+    return ring->kind == DAEMON_RING_MPMC || ring->kind == DAEMON_RING_SHM || ring->kind == DAEMON_RING_ELASTIC
+           || ring->spill;
+}
+
+/* ringbuffer a producer writes to, its own lane in a group */
+static rbctx_t* ring_lane(ring_t* ring, size_t producer) {
+    if (ring->kind == DAEMON_RING_GROUP) {
+        return ringbuffer_group_lane(&ring->group, producer);
+    }
+    return &ring->rb;
+}
+
+/* hand out room for one packet to fill in place, rings without
+ * reserve/commit get the caller's staging buffer instead */
+static int ring_write_reserve(ring_t* ring, size_t producer, unsigned char* staging, struct iovec vec[2]) {
+    if (ring_staged(ring)) {
+        vec[0].iov_base = staging;
+        vec[0].iov_len = MESSAGE_SIZE;
+        vec[1].iov_len = 0;
+        return SUCCESS;
+    }
+    //header + payload stay below 128 bytes, so the varint prefix is a single byte
+    return ringbuffer_write_reserve(ring_lane(ring, producer), sizeof(packet_header_t) + PACKET_PAYLOAD_SIZE, vec);
+}
+
+static int ring_write_commit(ring_t* ring, size_t producer, unsigned char* staging, size_t message_len) {
+    if (ring->kind == DAEMON_RING_MPMC) {
+        return mpmc_ringbuffer_write(&ring->mpmc, staging, message_len);
+    }
+    if (ring->kind == DAEMON_RING_SHM) {
+        return shm_ringbuffer_write(&ring->shm, staging, message_len);
+    }
+    if (ring->kind == DAEMON_RING_ELASTIC) {
+        return elastic_ringbuffer_write(&ring->elastic, staging, message_len);
+    }
+    if (ring->spill) {
+        return ringbuffer_write(&ring->rb, staging, message_len);
+    }
+    return ringbuffer_write_commit(ring_lane(ring, producer), message_len);
+}
+
+static void ring_write_abort(ring_t* ring, size_t producer) {
+    if (!ring_staged(ring)) {
+        ringbuffer_write_abort(ring_lane(ring, producer));
+    }
+}
+
+/* copy n bytes to offset off of the reserved segments */
+static void iov_put(struct iovec vec[2], size_t off, const void* src, size_t n) {
+    for (int i = 0; i < 2 && n > 0; i++) {
+        if (off >= vec[i].iov_len) {
+            off -= vec[i].iov_len;
+            continue;
+        }
+        size_t part = vec[i].iov_len - off < n ? vec[i].iov_len - off : n;
+        memcpy((unsigned char*) vec[i].iov_base + off, src, part);
+        src = (const unsigned char*) src + part;
+        n -= part;
+        off = 0;
+    }
+}
+
+/* fread up to n bytes to offset off of the reserved segments */
+static size_t iov_fread(struct iovec vec[2], size_t off, size_t n, FILE* fp) {
+    size_t total = 0;
+    for (int i = 0; i < 2 && n > 0; i++) {
+        if (off >= vec[i].iov_len) {
+            off -= vec[i].iov_len;
+            continue;
+        }
+        size_t part = vec[i].iov_len - off < n ? vec[i].iov_len - off : n;
+        size_t got = fread((unsigned char*) vec[i].iov_base + off, 1, part, fp);
+        total += got;
+        if (got < part) {
+            break;
+        }
+        n -= part;
+        off = 0;
+    }
+    return total;
+}
+
+/* all writers are joined, readers drain the ring and then get RINGBUFFER_CLOSED */
+static void ring_close(ring_t* ring) {
+    if (ring->kind == DAEMON_RING_LOCKED) {
+        ringbuffer_close(&ring->rb);
+    } else if (ring->kind == DAEMON_RING_GROUP) {
+        ringbuffer_group_close(&ring->group);
+    } else {
+        __atomic_store_n(&ring->writers_done, 1, __ATOMIC_RELEASE);
+    }
+}
+
+/* read up to READ_BATCH packets into buffer (READ_BATCH * MESSAGE_SIZE bytes),
+ * RINGBUFFER_CLOSED once ring_close was called and the ring is drained */
+static int ring_read_batch(ring_t* ring, unsigned char* buffer, size_t* offsets, size_t* nr_read) {
+    if (ring_staged(ring) && ring->kind != DAEMON_RING_LOCKED) {
+        size_t len = MESSAGE_SIZE;
+        *nr_read = 0;
+        offsets[0] = 0;
+        //the flag is loaded first: if it was set, every write happened before this read
+        int done = __atomic_load_n(&ring->writers_done, __ATOMIC_ACQUIRE);
+        int ret;
+        if (ring->kind == DAEMON_RING_SHM) {
+            ret = shm_ringbuffer_read(&ring->shm, buffer, &len);
+        } else if (ring->kind == DAEMON_RING_ELASTIC) {
+            ret = elastic_ringbuffer_read(&ring->elastic, buffer, &len);
+        } else {
+            ret = mpmc_ringbuffer_read(&ring->mpmc, buffer, &len);
+        }
+        if (ret == SUCCESS) {
+            *nr_read = 1;
+            offsets[1] = len;
+        }
+        return ret == RINGBUFFER_EMPTY && done ? RINGBUFFER_CLOSED : ret;
+    }
+    if (ring->kind == DAEMON_RING_GROUP) {
+        return ringbuffer_group_read_batch(&ring->group, buffer, READ_BATCH * MESSAGE_SIZE, offsets, READ_BATCH, nr_read);
+    }
+    return ringbuffer_read_batch(&ring->rb, buffer, READ_BATCH * MESSAGE_SIZE, offsets, READ_BATCH, nr_read);
+}
+
+/* one line of counters per ringbuffer, the high-water mark tells how
+ * much of ring_size was actually needed */
+static void ring_print_stats(ring_t* ring, size_t ring_size) {
+    size_t nr_lanes = 1;
+    if (ring->kind == DAEMON_RING_ELASTIC) {
+        printf("daemon: elastic ring: %zu bytes at shutdown, started with %zu\n",
+               elastic_ringbuffer_size(&ring->elastic), ring_size);
+        return;
+    } else if (ring_staged(ring) && ring->kind != DAEMON_RING_LOCKED) {
+        return;
+    } else if (ring->kind == DAEMON_RING_GROUP) {
+        nr_lanes = ring->group.nr_lanes;
+    }
+    for (size_t i = 0; i < nr_lanes; i++) {
+        rbstats_t stats;
+        ringbuffer_stats(ring_lane(ring, i), &stats);
+        printf("daemon: ring %zu: %llu packets, %llu bytes, %llu full, %llu spilled, %llu empty, %llu ms waited, high water %zu of %zu bytes\n",
+               i, (unsigned long long) stats.messages_in, (unsigned long long) stats.bytes_in,
+               (unsigned long long) stats.full, (unsigned long long) stats.spilled, (unsigned long long) stats.empty,
+               (unsigned long long) (stats.wait_ns / 1000000), stats.high_water, ring_size);
+
+        rblatency_t latency;
+        if (ringbuffer_latency(ring_lane(ring, i), &latency) == SUCCESS) {
+            printf("daemon: ring %zu: latency p50 %llu us, p99 %llu us, p99.9 %llu us, max %llu us\n", i,
+                   (unsigned long long) (latency.p50_ns / 1000), (unsigned long long) (latency.p99_ns / 1000),
+                   (unsigned long long) (latency.p999_ns / 1000), (unsigned long long) (latency.max_ns / 1000));
+        }
+    }
+}
 
 /* IN THE FOLLOWING IS THE CODE PROVIDED FOR YOU 
  * changing the code will result in points deduction */
@@ -26,16 +200,18 @@
 * simulates that data packets take varying amounts of time to arrive.
 *********************************************************************/
 typedef struct {
-    rbctx_t* ctx;
+    ring_t* ctx;
     connection_t* connection;
+    size_t producer;    /* lane of a DAEMON_RING_GROUP, packets of one connection stay in order */
 } w_thread_args_t;
 
 void* write_packets(void* arg) {
     /* extract arguments */
-    rbctx_t* ctx = ((w_thread_args_t*) arg)->ctx;
+    ring_t* ctx = ((w_thread_args_t*) arg)->ctx;
     size_t from = (size_t) ((w_thread_args_t*) arg)->connection->from;
     size_t to = (size_t) ((w_thread_args_t*) arg)->connection->to;
     char* filename = ((w_thread_args_t*) arg)->connection->filename;
+    size_t producer = ((w_thread_args_t*) arg)->producer;
 
     /* open file */
     FILE *fp = fopen(filename, "r");
@@ -44,20 +220,31 @@ void* write_packets(void* arg) {
         exit(1);
     }
 
-    /* read file in chunks and write to ringbuffer with random delay */
+    /* read file in chunks directly into the ringbuffer with random delay */
     unsigned char buf[MESSAGE_SIZE];
     size_t packet_id = 0;
     size_t read = 1;
     while (read > 0) {
-        size_t msg_size = MESSAGE_SIZE - 3 * sizeof(size_t);
-        read = fread(buf + 3 * sizeof(size_t), 1, msg_size, fp);
+        struct iovec vec[2];
+        while(ring_write_reserve(ctx, producer, buf, vec) != SUCCESS){
+            usleep(((rand() % 50) + 25)); // sleep for a random time between 25 and 75 us
+        }
+        size_t msg_size = PACKET_PAYLOAD_SIZE;
+        read = iov_fread(vec, sizeof(packet_header_t), msg_size, fp);
         if (read > 0) {
-            memcpy(buf, &from, sizeof(size_t));
-            memcpy(buf + sizeof(size_t), &to, sizeof(size_t));
-            memcpy(buf + 2 * sizeof(size_t), &packet_id, sizeof(size_t));
-            while(ringbuffer_write(ctx, buf, read + 3 * sizeof(size_t)) != SUCCESS){
+            packet_header_t header = {from, to, packet_id};
+            iov_put(vec, 0, &header, sizeof(header));
+            //rings without reserve/commit write here, a lost packet would stall its port forever
+            int ret;
+            while ((ret = ring_write_commit(ctx, producer, buf, read + sizeof(packet_header_t))) == RINGBUFFER_FULL) {
                 usleep(((rand() % 50) + 25)); // sleep for a random time between 25 and 75 us
             }
+            if (ret != SUCCESS) {
+                fprintf(stderr, "Cannot write packet %zu of %s: %d\n", packet_id, filename, ret);
+                exit(1);
+            }
+        } else {
+            ring_write_abort(ctx, producer);
         }
         packet_id++;
         usleep(((rand() % (100 -1)) + 1)); // sleep for a random time between 1 and 100 us
@@ -93,75 +280,78 @@ size_t filter(connection_t* connection, unsigned char* message, size_t len) {
 
 // 1. read functionality     --mimic the write, tbh
 typedef struct {
-    rbctx_t* ctx;
+    ring_t* ctx;
     pthread_mutex_t* mtx;
     pthread_cond_t* sig;
-    size_t* lastpacket_id;
+    size_t* nextpacket_id;
 } r_thread_args_t;
 
-void* read_packets(void* arg) 
+// handle one packet: keep the order per port, filter and append to the port's file
+static void handle_packet(r_thread_args_t* args, unsigned char* buf, size_t len)
 {
-    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
-    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-
-    unsigned char buf[MESSAGE_SIZE];
-    size_t len = MESSAGE_SIZE;
+    pthread_mutex_t* port_mtx = args->mtx;
+    pthread_cond_t* port_sig = args->sig;
+    size_t* nextpacket_id = args->nextpacket_id;
+
+    connection_t connection;
+    packet_header_t header;
+    memcpy(&header, buf, sizeof(header));
+    connection.from = header.from;
+    connection.to = header.to;
+    size_t packet_id = header.packet_id;
+    /* work on the payload where it was read to */
+    len = len - sizeof(header);
+    unsigned char* message = buf + sizeof(header);
 
-    pthread_mutex_t* port_mtx = ((r_thread_args_t*)arg)->mtx;
-    pthread_cond_t* port_sig = ((r_thread_args_t*)arg)->sig;
-    size_t* lastpacket_id = ((r_thread_args_t*)arg)->lastpacket_id;
     
-     while(1) {
-        while (ringbuffer_read(((r_thread_args_t*)arg)->ctx, buf, &len) != SUCCESS) {
-            // printf("No message to read\n");
-            // pthread_cond_wait(&sig, &mutex);
-            len = MESSAGE_SIZE;
-            pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-            usleep((rand() % 50) + 25); // sleep for a random time between 25 and 75 us
-            pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-        }
+    pthread_mutex_lock(&port_mtx[connection.to]);
+    while(packet_id != nextpacket_id[connection.to]) {
+        printf("Waiting for correct sequence...\n");
+        pthread_cond_wait(&port_sig[connection.to], &port_mtx[connection.to]);
+    }
 
-        connection_t connection;
-        size_t packet_id;
-        len = len - 3 * sizeof(size_t);
-        unsigned char message[MESSAGE_SIZE];
-        memcpy(&connection.from, buf, sizeof(size_t));
-        memcpy(&connection.to, buf + sizeof(size_t), sizeof(size_t));
-        memcpy(&packet_id, buf + 2 * sizeof(size_t), sizeof(size_t));
-        memcpy(&message, buf + 3 * sizeof(size_t), len);
-
-        
-        pthread_mutex_lock(&port_mtx[connection.to]);
-        if(packet_id != 0 && packet_id <= lastpacket_id[connection.to]) {
-            //do something to just skip this 
+    nextpacket_id[connection.to] = packet_id + 1;  //signify which packet is handled
+    if(filter(&connection, message, len)) {
+//            3. (thread-safe) write to file functionality
+        char portname[20];
+        sprintf(portname, "./%d.txt", connection.to);
+        FILE* port = fopen(portname, "a");
+        if (port == NULL) {
             pthread_cond_broadcast(&port_sig[connection.to]);
             pthread_mutex_unlock(&port_mtx[connection.to]);
-            continue;
-        }
-        while(packet_id > lastpacket_id[connection.to] + 1 && packet_id != 0) {
-            printf("Waiting for correct sequence...\n");
-            pthread_cond_wait(&port_sig[connection.to], &port_mtx[connection.to]);
+
+            exit(1);
         }
 
-        lastpacket_id[connection.to] = packet_id;  //signify which packet is handled
-        if(filter(&connection, message, len)) {
-//            3. (thread-safe) write to file functionality
-            char portname[20];
-            sprintf(portname, "./%d.txt", connection.to);
-            FILE* port = fopen(portname, "a");
-            if (port == NULL) {
-                pthread_cond_broadcast(&port_sig[connection.to]);
-                pthread_mutex_unlock(&port_mtx[connection.to]);
+        fwrite(message, sizeof(*message), len, port);
+        fclose(port);
+        printf("written: %d %d %zu %.*s \n", connection.from, connection.to, packet_id, (int) len, message);
+    }
+    pthread_cond_broadcast(&port_sig[connection.to]);
+    pthread_mutex_unlock(&port_mtx[connection.to]);
+}
 
-                exit(1);
+void* read_packets(void* arg) 
+{
+    /* drain bursts of packets at once, the ring is FIFO so handling them
+     * in order can't wait on a packet that is still queued behind us */
+    unsigned char buf[READ_BATCH * MESSAGE_SIZE];
+    size_t offsets[READ_BATCH + 1];
+    size_t nr_read;
+
+    /* runs until the writers are done and the ring is drained */
+     while(1) {
+        int ret;
+        while ((ret = ring_read_batch(((r_thread_args_t*)arg)->ctx, buf, offsets, &nr_read)) != SUCCESS) {
+            if (ret == RINGBUFFER_CLOSED) {
+                return NULL;
             }
+            usleep((rand() % 50) + 25); // sleep for a random time between 25 and 75 us
+        }
 
-            fwrite(message, sizeof(*message), len, port);
-            fclose(port);
-            printf("written: %d %d %zu %s \n", connection.from, connection.to, packet_id, message);
+        for (size_t i = 0; i < nr_read; i++) {
+            handle_packet(arg, buf + offsets[i], offsets[i + 1] - offsets[i]);
         }
-        pthread_cond_broadcast(&port_sig[connection.to]);
-        pthread_mutex_unlock(&port_mtx[connection.to]);
     }
 
     return NULL;
@@ -171,25 +361,110 @@ void* read_packets(void* arg)
 /********************************************************************/
 
 int simpledaemon(connection_t* connections, int nr_of_connections) {
+    daemon_options_t options = {
+        .ring = DAEMON_RING_LOCKED,
+        .ring_size = RINGBUFFER_SIZE,
+        .ring_size_max = 0,
+        .number_of_processing_threads = NUMBER_OF_PROCESSING_THREADS,
+        .number_of_lanes = 0,
+        .measure_latency = 0,
+        .shm_name = NULL,
+        .spill_dir = NULL,
+        .spill_size = 0,
+    };
+    return simpledaemon_with_options(connections, nr_of_connections, &options);
+}
+
+int simpledaemon_with_options(connection_t* connections, int nr_of_connections, const daemon_options_t* options) {
+    /* a ring that can't hold a packet or no reader at all would leave the writers waiting forever */
+    if (options->ring_size < MESSAGE_SIZE || options->number_of_processing_threads <= 0 || nr_of_connections < 0) {
+        fprintf(stderr, "Invalid options: ring_size %zu, %d processing threads, %d connections\n",
+                options->ring_size, options->number_of_processing_threads, nr_of_connections);
+        return 1;
+    }
+
     /* initialize ringbuffer */
-    rbctx_t rb_ctx;
-    size_t rbuf_size = 1024;
-    void *rbuf = malloc(rbuf_size);
-    if (rbuf == NULL) {
+    ring_t rb_ctx;
+    size_t rbuf_size = options->ring_size;
+    //use the whole memory when the size allows it
+    int rbuf_flags = RBUF_VARINT;
+    if ((rbuf_size & (rbuf_size - 1)) == 0) {
+        rbuf_flags |= RBUF_POW2;
+    }
+    if (options->measure_latency) {
+        rbuf_flags |= RBUF_TIMESTAMPS;
+    }
+    //a group, the shared memory and the elastic ring allocate their memory themselves
+    int own_memory = options->ring == DAEMON_RING_GROUP || options->ring == DAEMON_RING_SHM
+                     || options->ring == DAEMON_RING_ELASTIC;
+    void *rbuf = own_memory ? NULL : malloc(rbuf_size);
+    if (rbuf == NULL && !own_memory) {
         fprintf(stderr, "Error allocation ringbuffer\n");
+        exit(1);
     }
 
-    ringbuffer_init(&rb_ctx, rbuf, rbuf_size);
+    rb_ctx.kind = options->ring;
+    rb_ctx.spill = 0;
+    rb_ctx.writers_done = 0;
+    if (rb_ctx.kind == DAEMON_RING_SHM) {
+        const char* name = options->shm_name != NULL ? options->shm_name : DAEMON_SHM_NAME;
+        if (shm_ringbuffer_create(&rb_ctx.shm, name, rbuf_size) != SUCCESS) {
+            fprintf(stderr, "Cannot create shared memory ringbuffer %s\n", name);
+            exit(1);
+        }
+    } else if (rb_ctx.kind == DAEMON_RING_ELASTIC) {
+        size_t max_size = options->ring_size_max > 0 ? options->ring_size_max : DAEMON_ELASTIC_GROWTH * rbuf_size;
+        //the rings only frame messages, RBUF_TIMESTAMPS would add bytes nobody reads.
+        //RBUF_POW2 needs a power of two max_size as well, elastic_ringbuffer_init checks it
+        int elastic_flags = RBUF_VARINT;
+        if ((rbuf_flags & RBUF_POW2) && (max_size & (max_size - 1)) == 0) {
+            elastic_flags |= RBUF_POW2;
+        }
+        if (elastic_ringbuffer_init(&rb_ctx.elastic, rbuf_size, max_size, elastic_flags) != SUCCESS) {
+            fprintf(stderr, "Elastic ringbuffer of %zu to %zu bytes is invalid\n", rbuf_size, max_size);
+            exit(1);
+        }
+    } else if (rb_ctx.kind == DAEMON_RING_GROUP) {
+        size_t nr_lanes = options->number_of_lanes > 0 ? (size_t) options->number_of_lanes : (size_t) nr_of_connections;
+        if (ringbuffer_group_init(&rb_ctx.group, nr_lanes, rbuf_size, rbuf_flags, RBUF_GROUP_ROUND_ROBIN) != SUCCESS) {
+            fprintf(stderr, "Error allocation ringbuffer group of %zu lanes\n", nr_lanes);
+            exit(1);
+        }
+    } else if (rb_ctx.kind == DAEMON_RING_MPMC) {
+        if (mpmc_ringbuffer_init(&rb_ctx.mpmc, rbuf, rbuf_size, MESSAGE_SIZE) != SUCCESS) {
+            fprintf(stderr, "Ringbuffer of %zu bytes is too small for MESSAGE_SIZE slots\n", rbuf_size);
+            exit(1);
+        }
+    } else {
+        if (ringbuffer_init_flags(&rb_ctx.rb, rbuf, rbuf_size, rbuf_flags) != SUCCESS) {
+            fprintf(stderr, "Ringbuffer of %zu bytes is invalid\n", rbuf_size);
+            exit(1);
+        }
+        if (rb_ctx.kind == DAEMON_RING_LOCKED && options->spill_dir != NULL) {
+            size_t spill_size = options->spill_size > 0 ? options->spill_size : DAEMON_SPILL_SIZE;
+            if (ringbuffer_spill(&rb_ctx.rb, options->spill_dir, spill_size) != SUCCESS) {
+                fprintf(stderr, "Cannot create spill file in %s\n", options->spill_dir);
+                exit(1);
+            }
+            rb_ctx.spill = 1;
+        }
+    }
 
     /****************************************************************
     * WRITER THREADS 
     * ***************************************************************/
 
     /* prepare writer thread arguments */
-    w_thread_args_t w_thread_args[nr_of_connections];
+    w_thread_args_t* w_thread_args = malloc(nr_of_connections * sizeof(*w_thread_args));
+    pthread_t* w_threads = malloc(nr_of_connections * sizeof(*w_threads));
+    if (nr_of_connections > 0 && (w_thread_args == NULL || w_threads == NULL)) {
+        fprintf(stderr, "Error allocation writer threads\n");
+        exit(1);
+    }
     for (int i = 0; i < nr_of_connections; i++) {
         w_thread_args[i].ctx = &rb_ctx;
         w_thread_args[i].connection = &connections[i];
+        w_thread_args[i].producer = i;
         /* guarantee that port numbers range from MINIMUM_PORT (0) - MAXIMUMPORT */
         if (connections[i].from > MAXIMUM_PORT || connections[i].to > MAXIMUM_PORT ||
             connections[i].from < MINIMUM_PORT || connections[i].to < MINIMUM_PORT) {
@@ -199,7 +474,6 @@ int simpledaemon(connection_t* connections, int nr_of_connections) {
     }
 
     /* start writer threads */
-    pthread_t w_threads[nr_of_connections];
     for (int i = 0; i < nr_of_connections; i++) {
         pthread_create(&w_threads[i], NULL, write_packets, &w_thread_args[i]);
     }
@@ -208,7 +482,12 @@ int simpledaemon(connection_t* connections, int nr_of_connections) {
     * READER THREADS
     * ***************************************************************/
 
-    pthread_t r_threads[NUMBER_OF_PROCESSING_THREADS];
+    int nr_of_readers = options->number_of_processing_threads;
+    pthread_t* r_threads = malloc(nr_of_readers * sizeof(*r_threads));
+    if (r_threads == NULL) {
+        fprintf(stderr, "Error allocation reading threads\n");
+        exit(1);
+    }
 
     /* END OF PROVIDED CODE */
     
@@ -221,21 +500,21 @@ int simpledaemon(connection_t* connections, int nr_of_connections) {
 
     pthread_mutex_t port_mutex[MAXIMUM_PORT + 1];
     pthread_cond_t port_sig[MAXIMUM_PORT + 1];
-    size_t lastpacket_id[MAXIMUM_PORT + 1];
+    size_t nextpacket_id[MAXIMUM_PORT + 1];
     
     for (int i = 0; i < MAXIMUM_PORT + 1; i++) {
         pthread_mutex_init(&port_mutex[i], NULL);
         pthread_cond_init(&port_sig[i], NULL);
-        lastpacket_id[i] = 0;
+        nextpacket_id[i] = 0;
     }
     
     r_thread_args_t r_thread_args;
     r_thread_args.ctx = &rb_ctx;
     r_thread_args.mtx = port_mutex;
     r_thread_args.sig = port_sig;
-    r_thread_args.lastpacket_id = lastpacket_id;
+    r_thread_args.nextpacket_id = nextpacket_id;
 
-    for(int i = 0; i < NUMBER_OF_PROCESSING_THREADS; i++) {
+    for(int i = 0; i < nr_of_readers; i++) {
         pthread_create(&r_threads[i], NULL, read_packets, &r_thread_args);
     }
 
@@ -252,20 +531,17 @@ int simpledaemon(connection_t* connections, int nr_of_connections) {
      * CLEANUP
      * ***************************************************************/
 
-    /* after 5 seconds JOIN all threads (we should definitely have received all messages by then) */
-    printf("daemon: waiting for 5 seconds before canceling reading threads\n");
-    sleep(5);
-    for (int i = 0; i < NUMBER_OF_PROCESSING_THREADS; i++) {
-        pthread_cancel(r_threads[i]);
-    }
-
     /* wait for all threads to finish */
     for (int i = 0; i < nr_of_connections; i++) {
         pthread_join(w_threads[i], NULL);
     }
 
+    /* no more packets, the reading threads return once the ring is drained */
+    printf("daemon: writers done, waiting for reading threads to drain the ring\n");
+    ring_close(&rb_ctx);
+
     /* join all threads */
-    for (int i = 0; i < NUMBER_OF_PROCESSING_THREADS; i++) {
+    for (int i = 0; i < nr_of_readers; i++) {
         pthread_join(r_threads[i], NULL);
     }
 
@@ -283,6 +559,9 @@ int simpledaemon(connection_t* connections, int nr_of_connections) {
         pthread_mutex_destroy(&port_mutex[i]);
         pthread_cond_destroy(&port_sig[i]);
     }
+    free(r_threads);
+    free(w_threads);
+    free(w_thread_args);
 
     /* YOUR CODE ENDS HERE */
 
@@ -293,8 +572,19 @@ int simpledaemon(connection_t* connections, int nr_of_connections) {
     /* IN THE FOLLOWING IS THE CODE PROVIDED FOR YOU 
     * changing the code will result in points deduction */
 
+    ring_print_stats(&rb_ctx, rbuf_size);
+    if (rb_ctx.kind == DAEMON_RING_MPMC) {
+        mpmc_ringbuffer_destroy(&rb_ctx.mpmc);
+    } else if (rb_ctx.kind == DAEMON_RING_GROUP) {
+        ringbuffer_group_destroy(&rb_ctx.group);
+    } else if (rb_ctx.kind == DAEMON_RING_SHM) {
+        shm_ringbuffer_destroy(&rb_ctx.shm);
+    } else if (rb_ctx.kind == DAEMON_RING_ELASTIC) {
+        elastic_ringbuffer_destroy(&rb_ctx.elastic);
+    } else {
+        ringbuffer_destroy(&rb_ctx.rb);
+    }
     free(rbuf);
-    ringbuffer_destroy(&rb_ctx);
 
     return 0;
 
@@ -1,10 +1,158 @@
+#define _GNU_SOURCE
 #include "../include/ringbuf.h"
+#include "ringbuf_ctx.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <limits.h>
 #include <sys/types.h>
 
+uint64_t ringbuffer_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+//count a written message, mutex must be held
+static inline void rb_produced(rbctx_t *context, size_t prefix_len, size_t message_len)
+{
+    //head and tail are read without the mutex for a used estimate, see ringbuffer_group
+    __atomic_store_n(&context->head, context->head + prefix_len + message_len, __ATOMIC_RELAXED);
+    rb_stats_in(&context->stats, message_len, rb_capacity(context) - rb_space(context));
+}
+
+//histogram bucket of a latency, RBUF_HIST_SUB_BITS bits of precision per power of two
+static inline size_t rb_hist_bucket(uint64_t ns)
+{
+    if (ns < (1u << RBUF_HIST_SUB_BITS)) {
+        return ns;
+    }
+    unsigned shift = 63 - __builtin_clzll(ns) - RBUF_HIST_SUB_BITS;
+    return ((size_t)(shift + 1) << RBUF_HIST_SUB_BITS) + ((ns >> shift) & ((1u << RBUF_HIST_SUB_BITS) - 1));
+}
+
+//largest latency that falls into bucket
+static inline uint64_t rb_hist_value(size_t bucket)
+{
+    if (bucket < (1u << RBUF_HIST_SUB_BITS)) {
+        return bucket;
+    }
+    unsigned shift = (bucket >> RBUF_HIST_SUB_BITS) - 1;
+    uint64_t sub = (1u << RBUF_HIST_SUB_BITS) + (bucket & ((1u << RBUF_HIST_SUB_BITS) - 1));
+    return ((sub + 1) << shift) - 1;
+}
+
+//count a read message, from memory or the spill file
+static inline void rb_count_out(rbctx_t *context, size_t message_len, uint64_t enqueued_ns)
+{
+    rb_stats_out(&context->stats, message_len);
+    if (context->latency != NULL) {
+        uint64_t ns = ringbuffer_now_ns() - enqueued_ns;
+        context->latency->buckets[rb_hist_bucket(ns)]++;
+        context->latency->count++;
+        if (ns > context->latency->max_ns) {
+            context->latency->max_ns = ns;
+        }
+    }
+}
+
+//count a read message, mutex must be held
+static inline void rb_consumed(rbctx_t *context, size_t prefix_len, size_t message_len, uint64_t enqueued_ns)
+{
+    __atomic_store_n(&context->tail, context->tail + prefix_len + message_len, __ATOMIC_RELAXED);
+    rb_count_out(context, message_len, enqueued_ns);
+}
+
+/* in front of every message in the spill file */
+typedef struct {
+    uint64_t len;
+    uint64_t enqueued_ns;   //0 without RBUF_TIMESTAMPS
+    uint64_t head;          //memory head when it was spilled, the messages in memory before it are older
+} rb_spill_hdr_t;
+
+/* where a message goes */
+enum { RB_NO_ROOM, RB_TO_RING, RB_TO_SPILL };
+
+//where a message of message_len bytes fits right now, memory first, mutex must be held
+static inline int rb_room(rbctx_t *context, size_t message_len)
+{
+    if (rb_space(context) >= message_len + rb_prefix_len(context, message_len)) {
+        return RB_TO_RING;
+    }
+    if (context->spill != NULL
+        && rb_frame_space(context->spill_size, context->spill_tail, context->spill_head)
+           >= sizeof(rb_spill_hdr_t) + message_len) {
+        return RB_TO_SPILL;
+    }
+    return RB_NO_ROOM;
+}
+
+//append the concatenation of iov to the spill file, it wraps around like the memory, mutex must be held
+static void rb_spill_put(rbctx_t *context, const struct iovec *iov, int iovcnt, size_t message_len)
+{
+    rb_spill_hdr_t hdr = {message_len, context->latency != NULL ? ringbuffer_now_ns() : 0, context->head};
+    size_t pos = rb_frame_put(context->spill, context->spill_size, context->spill_head, &hdr, sizeof(hdr));
+    for (int i = 0; i < iovcnt; i++) {
+        pos = rb_frame_put(context->spill, context->spill_size, pos, iov[i].iov_base, iov[i].iov_len);
+    }
+    context->spill_head = pos;
+    context->stats.messages_in++;
+    context->stats.bytes_in += message_len;
+    context->stats.spilled++;
+}
+
+/*
+ * Prefix of the oldest message, mutex must be held and a message pending.
+ * Memory and the spill file are both in write order, a spilled message
+ * goes first once the memory messages written before it are read (tail
+ * reached its head). spilled tells where it is, returns its position.
+ */
+static uint8_t* rb_oldest(rbctx_t *context, size_t *message_len, size_t *prefix_len, uint64_t *enqueued_ns,
+                          int *spilled)
+{
+    rb_spill_hdr_t hdr;
+    *spilled = 0;
+    if (!rb_spill_empty(context)) {
+        rb_frame_get(context->spill, context->spill_size, context->spill_tail, &hdr, sizeof(hdr));
+        *spilled = rb_empty(context) || hdr.head == context->tail;
+    }
+    if (!*spilled) {
+        return rb_get_len(context, context->read, message_len, prefix_len, enqueued_ns);
+    }
+    *message_len = hdr.len;
+    *prefix_len = sizeof(hdr);
+    *enqueued_ns = hdr.enqueued_ns;
+    return context->spill + (context->spill_tail + sizeof(hdr)) % context->spill_size;
+}
+
+//copy out of memory or the spill file, returns the position after the copied bytes
+static inline uint8_t* rb_copy_out(rbctx_t *context, int spilled, uint8_t *pos, void *dst, size_t n)
+{
+    if (spilled) {
+        return context->spill + rb_frame_get(context->spill, context->spill_size, pos - context->spill, dst, n);
+    }
+    return rb_get(context, pos, dst, n);
+}
+
+//drop the oldest message, next is the position after it, mutex must be held
+static void rb_take(rbctx_t *context, int spilled, uint8_t *next, size_t prefix_len, size_t message_len,
+                    uint64_t enqueued_ns)
+{
+    if (!spilled) {
+        context->read = next;
+        rb_consumed(context, prefix_len, message_len, enqueued_ns);
+        return;
+    }
+    context->spill_tail = next - context->spill;
+    rb_count_out(context, message_len, enqueued_ns);
+}
+
 void ringbuffer_init(rbctx_t *context, void *buffer_location, size_t buffer_size)
 {
     /* your solution here */
@@ -12,140 +160,649 @@ void ringbuffer_init(rbctx_t *context, void *buffer_location, size_t buffer_size
     context->read = context->begin;
     context->write = context->begin;
     context->end = context->begin+buffer_size;
+    context->head = 0;
+    context->tail = 0;
+    context->mask = 0;
+    context->flags = 0;
+    context->reserved = NULL;
+    context->reserved_len = 0;
+    context->peeked = NULL;
+    context->latency = NULL;
+    context->mapped_len = 0;
+    context->read_fd = -1;
+    context->write_fd = -1;
+    context->fd_state = 0;
+    context->spill = NULL;
+    context->spill_size = 0;
+    context->spill_head = 0;
+    context->spill_tail = 0;
+    context->closed = 0;
+    context->bell = NULL;
+    memset(&context->stats, 0, sizeof(context->stats));
 
-    pthread_mutex_init(&context->mtx, NULL);
+    rb_init_sync(context);
+}
 
-    pthread_cond_init(&context->sig, NULL);
+int ringbuffer_init_flags(rbctx_t *context, void *buffer_location, size_t buffer_size, int flags)
+{
+    //size 0 would wrap the capacity around to SIZE_MAX
+    if (buffer_size == 0 || ((flags & RBUF_POW2) && (buffer_size & (buffer_size - 1)) != 0)) {
+        return RINGBUFFER_INVALID;
+    }
+    if ((flags & RBUF_WAIT_SPIN) && (flags & RBUF_WAIT_BACKOFF)) {
+        return RINGBUFFER_INVALID;
+    }
+    ringbuffer_init(context, buffer_location, buffer_size);
+    if (flags & RBUF_TIMESTAMPS) {
+        context->latency = calloc(1, sizeof(rbhist_t));
+        if (context->latency == NULL) {
+            ringbuffer_destroy(context);
+            return RINGBUFFER_INVALID;
+        }
+    }
+    if (flags & RBUF_EVENTFD) {
+        //empty and with room, only write_fd starts readable
+        context->read_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        context->write_fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+        context->fd_state = RB_FD_WRITE;
+        if (context->read_fd < 0 || context->write_fd < 0) {
+            ringbuffer_destroy(context);
+            return RINGBUFFER_INVALID;
+        }
+    }
+    context->flags = flags & ~RBUF_MIRRORED;
+    context->mask = buffer_size - 1;
+    return SUCCESS;
 }
 
-int ringbuffer_write(rbctx_t *context, void *message, size_t message_len)
+int ringbuffer_init_mirrored(rbctx_t *context, size_t buffer_size, int flags)
 {
-    /* your solution here */
+    size_t page = sysconf(_SC_PAGESIZE);
+    buffer_size = (buffer_size + page - 1) / page * page;
+    if (buffer_size == 0 || ((flags & RBUF_POW2) && (buffer_size & (buffer_size - 1)) != 0)) {
+        return RINGBUFFER_INVALID;
+    }
+
+    int fd = memfd_create("ringbuffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        return RINGBUFFER_INVALID;
+    }
+    if (ftruncate(fd, buffer_size) != 0) {
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+
+    //reserve twice the address space, then map the same pages into both halves
+    uint8_t *base = mmap(NULL, 2 * buffer_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    if (mmap(base, buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + buffer_size, buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, 2 * buffer_size);
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    close(fd);
+
+    if (ringbuffer_init_flags(context, base, buffer_size, flags) != SUCCESS) {
+        munmap(base, 2 * buffer_size);
+        return RINGBUFFER_INVALID;
+    }
+    context->flags |= RBUF_MIRRORED;
+    return SUCCESS;
+}
+
+static inline size_t rb_iov_len(const struct iovec *iov, int iovcnt)
+{
+    size_t len = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        len += iov[i].iov_len;
+    }
+    return len;
+}
+
+int ringbuffer_spill(rbctx_t *context, const char *dir, size_t spill_size)
+{
+    if (context->spill != NULL || spill_size == 0) {
+        return RINGBUFFER_INVALID;
+    }
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/ringbuf-spill-XXXXXX", dir) >= (int) sizeof(path)) {
+        return RINGBUFFER_INVALID;
+    }
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return RINGBUFFER_INVALID;
+    }
+    //nobody else needs the name, the file goes away with the mapping
+    unlink(path);
+    if (ftruncate(fd, spill_size) != 0) {
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    uint8_t *spill = mmap(NULL, spill_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (spill == MAP_FAILED) {
+        return RINGBUFFER_INVALID;
+    }
+
+    pthread_mutex_lock(&context->mtx);
+    context->spill = spill;
+    context->spill_size = spill_size;
+    context->spill_head = 0;
+    context->spill_tail = 0;
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+//write the concatenation of iov as one message
+static int rb_writev(rbctx_t *context, const struct iovec *iov, int iovcnt, uint64_t deadline_ns)
+{
+    size_t message_len = rb_iov_len(iov, iovcnt);
     pthread_mutex_lock(&context->mtx);
 
     //Check if there's enough space
-    while((context->write < context->read) && ((size_t)(message_len + sizeof(size_t)) >= (size_t)(context->read - context->write))) {
-        int check = 0;
-        struct timespec waittime;
-        clock_gettime(CLOCK_REALTIME, &waittime);
-        waittime.tv_sec += 1;
-        check = pthread_cond_timedwait(&context->sig, &context->mtx, &waittime);
-        if(check == ETIMEDOUT) {
+    int room;
+    while(!context->closed && (context->reserved != NULL || (room = rb_room(context, message_len)) == RB_NO_ROOM)) {
+        if(rb_wait_not_full(context, deadline_ns) == ETIMEDOUT) {
+            rb_full(context);
             pthread_mutex_unlock(&context->mtx);
             return RINGBUFFER_FULL;
         }
     }
+    if (context->closed) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_CLOSED;
+    }
 
-    while((context->write >= context->read) && (message_len + sizeof(size_t) >= (size_t)(context->end-context->begin - (context->write - context->read)))) {
-        int check = 0;
-        struct timespec waittime;
-        clock_gettime(CLOCK_REALTIME, &waittime);
-        waittime.tv_sec += 1;
-        check = pthread_cond_timedwait(&context->sig, &context->mtx, &waittime);
-        if(check == ETIMEDOUT) {
+    if (room == RB_TO_SPILL) {
+        rb_spill_put(context, iov, iovcnt, message_len);
+    } else {
+        //write length and message
+        size_t prefix_len = rb_prefix_len(context, message_len);
+        context->write = rb_put_len(context, context->write, message_len, prefix_len);
+        for (int i = 0; i < iovcnt; i++) {
+            context->write = rb_put(context, context->write, iov[i].iov_base, iov[i].iov_len);
+        }
+        rb_produced(context, prefix_len, message_len);
+    }
+
+    rb_notify_readers(context, 0);
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+static inline int rb_write(rbctx_t *context, void *message, size_t message_len, uint64_t deadline_ns)
+{
+    struct iovec iov = {message, message_len};
+    return rb_writev(context, &iov, 1, deadline_ns);
+}
+
+//read one message and scatter it over iov in order, message_len receives its size
+static int rb_readv(rbctx_t *context, const struct iovec *iov, int iovcnt, size_t *message_len_ptr,
+                    uint64_t deadline_ns)
+{
+    size_t buffer_len = rb_iov_len(iov, iovcnt);
+    pthread_mutex_lock(&context->mtx);
+    while(!rb_drained(context) && (!rb_pending(context) || context->peeked != NULL)) {
+        if(rb_wait_not_empty(context, deadline_ns) == ETIMEDOUT) {
+            context->stats.empty++;
             pthread_mutex_unlock(&context->mtx);
-            return RINGBUFFER_FULL;
+            return RINGBUFFER_EMPTY;
         }
     }
+    if (rb_drained(context)) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_CLOSED;
+    }
 
-    //write length
-    if (context->write + sizeof(size_t) >= context->end) {
-        size_t firstpart = context->end - context->write;
-        memcpy(context->write, &message_len, firstpart);
-        memcpy(context->begin, (uint8_t*)&message_len + firstpart, sizeof(size_t) - firstpart);
-    } else {
-        memcpy(context->write, &message_len, sizeof(size_t));
+    //read length
+    size_t message_len = 0;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    int spilled;
+    uint8_t *payload = rb_oldest(context, &message_len, &prefix_len, &enqueued_ns, &spilled);
+
+    //not change pointer if buffer too small, the caller retries with the required size
+    if(message_len > buffer_len) {
+        *message_len_ptr = message_len;
+        pthread_mutex_unlock(&context->mtx);
+        return OUTPUT_BUFFER_TOO_SMALL;
     }
-    context->write += sizeof(size_t);
-    if (context->write >= context->end) {
-        context->write -= (context->end - context->begin);
+
+    //read message
+    *message_len_ptr = message_len;
+    size_t left = message_len;
+    for (int i = 0; i < iovcnt && left > 0; i++) {
+        size_t n = iov[i].iov_len < left ? iov[i].iov_len : left;
+        payload = rb_copy_out(context, spilled, payload, iov[i].iov_base, n);
+        left -= n;
     }
+    rb_take(context, spilled, payload, prefix_len, message_len, enqueued_ns);
+
+    rb_notify_writers(context);
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
 
-    //write message
-    if(context->write < context->read)  {
-        memcpy(context->write, message, message_len);
-        context->write += message_len;
+static inline int rb_read(rbctx_t *context, void *buffer, size_t *buffer_len, uint64_t deadline_ns)
+{
+    struct iovec iov = {buffer, *buffer_len};
+    return rb_readv(context, &iov, 1, buffer_len, deadline_ns);
+}
+
+int ringbuffer_peek_len(rbctx_t *context, size_t *message_len)
+{
+    pthread_mutex_lock(&context->mtx);
+    if (!rb_pending(context) || context->peeked != NULL) {
+        int ret = rb_drained(context) ? RINGBUFFER_CLOSED : RINGBUFFER_EMPTY;
+        pthread_mutex_unlock(&context->mtx);
+        return ret;
     }
-    else {
-        if(context->write + message_len < context->end) {
-            memcpy(context->write, message, message_len); 
-            context->write += message_len;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    int spilled;
+    rb_oldest(context, message_len, &prefix_len, &enqueued_ns, &spilled);
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+int ringbuffer_write(rbctx_t *context, void *message, size_t message_len)
+{
+    /* your solution here */
+    return rb_write(context, message, message_len, rb_default_deadline());
+}
+
+int ringbuffer_read(rbctx_t *context, void *buffer, size_t *buffer_len)
+{
+    /* your solution here */
+    return rb_read(context, buffer, buffer_len, rb_default_deadline());
+}
+
+int ringbuffer_writev(rbctx_t *context, const struct iovec *iov, int iovcnt)
+{
+    return rb_writev(context, iov, iovcnt, rb_default_deadline());
+}
+
+int ringbuffer_readv(rbctx_t *context, const struct iovec *iov, int iovcnt, size_t *message_len)
+{
+    return rb_readv(context, iov, iovcnt, message_len, rb_default_deadline());
+}
+
+int ringbuffer_try_write(rbctx_t *context, void *message, size_t message_len)
+{
+    return rb_write(context, message, message_len, RBUF_NO_WAIT);
+}
+
+int ringbuffer_try_read(rbctx_t *context, void *buffer, size_t *buffer_len)
+{
+    return rb_read(context, buffer, buffer_len, RBUF_NO_WAIT);
+}
+
+int ringbuffer_write_until(rbctx_t *context, void *message, size_t message_len, uint64_t deadline_ns)
+{
+    return rb_write(context, message, message_len, deadline_ns);
+}
+
+int ringbuffer_read_until(rbctx_t *context, void *buffer, size_t *buffer_len, uint64_t deadline_ns)
+{
+    return rb_read(context, buffer, buffer_len, deadline_ns);
+}
+
+int ringbuffer_write_blocking(rbctx_t *context, void *message, size_t message_len)
+{
+    //a message that can never fit would wait forever, the spill file may take more than memory
+    if (message_len + rb_prefix_len(context, message_len) > rb_capacity(context)
+        && (context->spill == NULL || sizeof(rb_spill_hdr_t) + message_len > context->spill_size - 1)) {
+        return RINGBUFFER_INVALID;
+    }
+    return rb_write(context, message, message_len, RBUF_WAIT_FOREVER);
+}
+
+int ringbuffer_read_blocking(rbctx_t *context, void *buffer, size_t *buffer_len)
+{
+    return rb_read(context, buffer, buffer_len, RBUF_WAIT_FOREVER);
+}
+
+int ringbuffer_write_batch(rbctx_t *context, const struct iovec *messages, size_t count, size_t *nr_written)
+{
+    *nr_written = 0;
+    if (count == 0) {
+        return SUCCESS;
+    }
+
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&context->mtx);
+
+    //wait until at least the first message fits
+    while(!context->closed && (context->reserved != NULL || rb_room(context, messages[0].iov_len) == RB_NO_ROOM)) {
+        if(rb_wait_not_full(context, deadline_ns) == ETIMEDOUT) {
+            rb_full(context);
+            pthread_mutex_unlock(&context->mtx);
+            return RINGBUFFER_FULL;
         }
-        else {
-            uint8_t first_part_len = context->end - context->write;
-            uint8_t second_part_len = message_len - first_part_len;
-            memcpy(context->write, message, first_part_len);
-            memcpy(context->begin, message + first_part_len, second_part_len);
-            context->write = context->begin + second_part_len;
+    }
+    if (context->closed) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_CLOSED;
+    }
+
+    //then write as many as fit without waiting again
+    size_t i = 0;
+    while(i < count) {
+        size_t message_len = messages[i].iov_len;
+        int room = rb_room(context, message_len);
+        if (room == RB_NO_ROOM) {
+            break;
         }
+        if (room == RB_TO_SPILL) {
+            rb_spill_put(context, &messages[i], 1, message_len);
+        } else {
+            size_t prefix_len = rb_prefix_len(context, message_len);
+            context->write = rb_put_len(context, context->write, message_len, prefix_len);
+            context->write = rb_put(context, context->write, messages[i].iov_base, message_len);
+            rb_produced(context, prefix_len, message_len);
+        }
+        i++;
     }
+    *nr_written = i;
+
+    //several readers may have something to do now
+    rb_notify_readers(context, i > 1);
     pthread_mutex_unlock(&context->mtx);
-    pthread_cond_signal(&context->sig);
     return SUCCESS;
 }
 
-int ringbuffer_read(rbctx_t *context, void *buffer, size_t *buffer_len)
+int ringbuffer_read_batch(rbctx_t *context, void *buffer, size_t buffer_len,
+                          size_t *offsets, size_t max_messages, size_t *nr_read)
 {
-    /* your solution here */
+    return ringbuffer_read_batch_until(context, buffer, buffer_len, offsets, max_messages, nr_read,
+                                       rb_default_deadline());
+}
+
+int ringbuffer_read_batch_until(rbctx_t *context, void *buffer, size_t buffer_len,
+                                size_t *offsets, size_t max_messages, size_t *nr_read, uint64_t deadline_ns)
+{
+    *nr_read = 0;
+    offsets[0] = 0;
+    if (max_messages == 0) {
+        return SUCCESS;
+    }
+
     pthread_mutex_lock(&context->mtx);
-    while(context->read == context->write) {
-        int check = 0;
-        struct timespec waittime;
-        clock_gettime(CLOCK_REALTIME, &waittime);
-        waittime.tv_sec += 1;
-        check = pthread_cond_timedwait(&context->sig, &context->mtx, &waittime);
-        if(check == ETIMEDOUT) {
+    while(!rb_drained(context) && (!rb_pending(context) || context->peeked != NULL)) {
+        if(rb_wait_not_empty(context, deadline_ns) == ETIMEDOUT) {
+            context->stats.empty++;
             pthread_mutex_unlock(&context->mtx);
             return RINGBUFFER_EMPTY;
         }
     }
+    if (rb_drained(context)) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_CLOSED;
+    }
 
-    //read length
-    size_t message_len = 0;
-    if (context->read + sizeof(size_t) >= context->end) {
-        size_t firstpart = context->end - context->read;
-        memcpy(&message_len, context->read, firstpart);
-        memcpy(((uint8_t*)&message_len) + firstpart, context->begin, sizeof(size_t) - firstpart);
-    } 
-    else {
-        memcpy(&message_len, context->read, sizeof(size_t));
-    }
-
-    //Check cond and not change pointer if buffer too small
-    while(message_len > *buffer_len) {
-        int check = 0;
-        struct timespec waittime;
-        clock_gettime(CLOCK_REALTIME, &waittime);
-        waittime.tv_sec += 1;
-        check = pthread_cond_timedwait(&context->sig, &context->mtx, &waittime);
-        if(check == ETIMEDOUT) {
+    //drain until the ringbuffer is empty, max_messages are read or the next one doesn't fit
+    size_t n = 0;
+    size_t used = 0;
+    while(n < max_messages && rb_pending(context)) {
+        size_t message_len = 0;
+        size_t prefix_len;
+        uint64_t enqueued_ns;
+        int spilled;
+        uint8_t *payload = rb_oldest(context, &message_len, &prefix_len, &enqueued_ns, &spilled);
+        if (message_len > buffer_len - used) {
+            break;
+        }
+        payload = rb_copy_out(context, spilled, payload, (uint8_t*)buffer + used, message_len);
+        rb_take(context, spilled, payload, prefix_len, message_len, enqueued_ns);
+        used += message_len;
+        offsets[++n] = used;
+    }
+    *nr_read = n;
+
+    if (n > 0) {
+        rb_notify_writers(context);
+    }
+    pthread_mutex_unlock(&context->mtx);
+    return n > 0 ? SUCCESS : OUTPUT_BUFFER_TOO_SMALL;
+}
+
+int ringbuffer_write_reserve(rbctx_t *context, size_t max_len, struct iovec vec[2])
+{
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&context->mtx);
+
+    //reservations never spill, they wait for room in memory
+    size_t prefix_len = rb_prefix_len(context, max_len);
+    while(!context->closed && (context->reserved != NULL || rb_space(context) < max_len + prefix_len)) {
+        if(rb_wait_not_full(context, deadline_ns) == ETIMEDOUT) {
+            rb_full(context);
+            pthread_mutex_unlock(&context->mtx);
+            return RINGBUFFER_FULL;
+        }
+    }
+    if (context->closed) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_CLOSED;
+    }
+
+    //the length prefix is written on commit, hand out the space after it
+    context->reserved = rb_advance(context, context->write, prefix_len);
+    context->reserved_len = max_len;
+    rb_segments(context, context->reserved, max_len, vec);
+
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+int ringbuffer_write_commit(rbctx_t *context, size_t message_len)
+{
+    pthread_mutex_lock(&context->mtx);
+    if (context->reserved == NULL || message_len > context->reserved_len) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_INVALID;
+    }
+
+    //keep the prefix width of the reservation, the message starts behind it
+    size_t prefix_len = rb_prefix_len(context, context->reserved_len);
+    rb_put_len(context, context->write, message_len, prefix_len);
+    context->write = rb_advance(context, context->reserved, message_len);
+    rb_produced(context, prefix_len, message_len);
+    context->reserved = NULL;
+
+    rb_notify_readers(context, 0);
+    //writers waiting for the reservation to end
+    rb_notify_writers(context);
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+void ringbuffer_write_abort(rbctx_t *context)
+{
+    pthread_mutex_lock(&context->mtx);
+    context->reserved = NULL;
+    //after ringbuffer_close the readers only waited for this reservation
+    if (context->closed) {
+        rb_notify_readers(context, 1);
+    }
+    rb_notify_writers(context);
+    pthread_mutex_unlock(&context->mtx);
+}
+
+int ringbuffer_read_peek(rbctx_t *context, struct iovec vec[2])
+{
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&context->mtx);
+    while(!rb_drained(context) && (!rb_pending(context) || context->peeked != NULL)) {
+        if(rb_wait_not_empty(context, deadline_ns) == ETIMEDOUT) {
+            context->stats.empty++;
             pthread_mutex_unlock(&context->mtx);
             return RINGBUFFER_EMPTY;
         }
     }
-    
-    context->read += sizeof(size_t);
-    if (context->read >= context->end) {
-        context->read -= (context->end - context->begin);
+    if (rb_drained(context)) {
+        pthread_mutex_unlock(&context->mtx);
+        return RINGBUFFER_CLOSED;
     }
-    
-    //read message
-    *buffer_len = message_len;
-    if(context->read + message_len >= context->end) {
-        int cut = context->end - context->read;
-        memcpy(buffer, context->read, cut);
-        memcpy(buffer + cut, context->begin, message_len-cut);
-        context->read = context->begin + message_len - cut;
-        
+
+    size_t message_len = 0;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    int spilled;
+    uint8_t *payload = rb_oldest(context, &message_len, &prefix_len, &enqueued_ns, &spilled);
+    if (spilled) {
+        //the file wraps around like the memory, but is never mirrored
+        size_t first = context->spill + context->spill_size - payload;
+        vec[0].iov_base = payload;
+        vec[0].iov_len = message_len < first ? message_len : first;
+        vec[1].iov_base = context->spill;
+        vec[1].iov_len = message_len - vec[0].iov_len;
+        context->peeked = context->spill + (payload - context->spill + message_len) % context->spill_size;
+    } else {
+        rb_segments(context, payload, message_len, vec);
+        context->peeked = rb_advance(context, payload, message_len);
+    }
+
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+int ringbuffer_read_release(rbctx_t *context)
+{
+    pthread_mutex_lock(&context->mtx);
+    if (context->peeked == NULL) {
         pthread_mutex_unlock(&context->mtx);
-        pthread_cond_signal(&context->sig);
-        return SUCCESS;
+        return RINGBUFFER_INVALID;
+    }
+
+    //writes since the peek are newer, the oldest message is still the peeked one
+    size_t message_len;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    int spilled;
+    rb_oldest(context, &message_len, &prefix_len, &enqueued_ns, &spilled);
+    rb_take(context, spilled, context->peeked, prefix_len, message_len, enqueued_ns);
+    context->peeked = NULL;
+
+    rb_notify_writers(context);
+    //readers waiting for the peek to end
+    rb_notify_readers(context, 0);
+    pthread_mutex_unlock(&context->mtx);
+    return SUCCESS;
+}
+
+int ringbuffer_read_fd(rbctx_t *context)
+{
+    return context->read_fd;
+}
+
+int ringbuffer_write_fd(rbctx_t *context)
+{
+    return context->write_fd;
+}
+
+int ringbuffer_poll(rbctx_t **contexts, size_t count, size_t *ready, uint64_t deadline_ns)
+{
+    if (count == 0) {
+        return RINGBUFFER_INVALID;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (contexts[i]->read_fd < 0) {
+            return RINGBUFFER_INVALID;
+        }
+    }
+    //count comes from the caller, so not on the stack
+    struct pollfd *fds = calloc(count, sizeof(struct pollfd));
+    if (fds == NULL) {
+        return RINGBUFFER_INVALID;
+    }
+    for (size_t i = 0; i < count; i++) {
+        fds[i].fd = contexts[i]->read_fd;
+        fds[i].events = POLLIN;
+    }
+
+    int ret = RINGBUFFER_EMPTY;
+    for (;;) {
+        int timeout_ms = -1;
+        if (deadline_ns != RBUF_WAIT_FOREVER) {
+            uint64_t now_ns = ringbuffer_now_ns();
+            //round up, poll must not return before the deadline. Deadlines more than
+            //INT_MAX ms (~24 days) away wait in several polls
+            uint64_t left_ms = deadline_ns <= now_ns ? 0 : (deadline_ns - now_ns + 999999) / 1000000;
+            timeout_ms = left_ms > INT_MAX ? INT_MAX : (int) left_ms;
+        }
+        int nr_ready = poll(fds, count, timeout_ms);
+        if (nr_ready < 0 && errno != EINTR) {
+            ret = RINGBUFFER_INVALID;
+            break;
+        }
+        for (size_t i = 0; nr_ready > 0 && i < count; i++) {
+            if (fds[i].revents & POLLIN) {
+                *ready = i;
+                ret = SUCCESS;
+                break;
+            }
+        }
+        if (ret == SUCCESS || (nr_ready == 0 && timeout_ms == 0)) {
+            break;
+        }
+    }
+    free(fds);
+    return ret;
+}
+
+void ringbuffer_close(rbctx_t *context)
+{
+    pthread_mutex_lock(&context->mtx);
+    context->closed = 1;
+    //no data or space transition wakes the waiters, both sides have to check again
+    rb_notify_readers(context, 1);
+    rb_notify_writers(context);
+    pthread_mutex_unlock(&context->mtx);
+}
+
+size_t ringbuffer_used(rbctx_t *context)
+{
+    pthread_mutex_lock(&context->mtx);
+    size_t used = rb_capacity(context) - rb_space(context);
+    pthread_mutex_unlock(&context->mtx);
+    return used;
+}
+
+void ringbuffer_stats(rbctx_t *context, rbstats_t *stats)
+{
+    pthread_mutex_lock(&context->mtx);
+    *stats = context->stats;
+    pthread_mutex_unlock(&context->mtx);
+}
+
+int ringbuffer_latency(rbctx_t *context, rblatency_t *latency)
+{
+    if (!(context->flags & RBUF_TIMESTAMPS)) {
+        return RINGBUFFER_INVALID;
+    }
+    pthread_mutex_lock(&context->mtx);
+    rbhist_t *hist = context->latency;
+    latency->count = hist->count;
+    latency->max_ns = hist->max_ns;
+
+    //smallest bucket that holds at least the wanted share of all messages
+    const uint64_t per_mille[3] = {500, 990, 999};
+    uint64_t *result[3] = {&latency->p50_ns, &latency->p99_ns, &latency->p999_ns};
+    size_t bucket = 0;
+    uint64_t seen = 0;
+    for (int i = 0; i < 3; i++) {
+        uint64_t wanted = (hist->count * per_mille[i] + 999) / 1000;
+        while (bucket < RBUF_HIST_BUCKETS && seen + hist->buckets[bucket] < wanted) {
+            seen += hist->buckets[bucket++];
+        }
+        uint64_t value = bucket < RBUF_HIST_BUCKETS ? rb_hist_value(bucket) : hist->max_ns;
+        *result[i] = hist->count == 0 ? 0 : (value < hist->max_ns ? value : hist->max_ns);
     }
-    memcpy(buffer, context->read, message_len);
-    context->read += message_len;
-    
     pthread_mutex_unlock(&context->mtx);
-    pthread_cond_signal(&context->sig);
     return SUCCESS;
 }
 
@@ -154,5 +811,20 @@ void ringbuffer_destroy(rbctx_t *context)
     /* your solution here */
     pthread_mutex_destroy(&context->mtx);
 
-    pthread_cond_destroy(&context->sig);
+    pthread_cond_destroy(&context->not_empty);
+    pthread_cond_destroy(&context->not_full);
+
+    if (context->flags & RBUF_MIRRORED) {
+        munmap(context->begin, 2 * rb_size(context));
+    }
+    free(context->latency);
+    if (context->read_fd >= 0) {
+        close(context->read_fd);
+    }
+    if (context->write_fd >= 0) {
+        close(context->write_fd);
+    }
+    if (context->spill != NULL) {
+        munmap(context->spill, context->spill_size);
+    }
 }
@@ -0,0 +1,111 @@
+#define _GNU_SOURCE
+#include "../include/ringbuf.h"
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define RB_HUGEPAGE_SIZE (2ul << 20)
+#define RB_MPOL_BIND 2  //from numaif.h, mbind is called directly so libnuma isn't needed
+
+static size_t round_up(size_t n, size_t to)
+{
+    return (n + to - 1) / to * to;
+}
+
+//len bytes starting at a multiple of align, so transparent huge pages can back them
+static uint8_t* map_aligned(size_t len, size_t align)
+{
+    uint8_t *base = mmap(NULL, len + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    uint8_t *mem = (uint8_t *) round_up((uintptr_t) base, align);
+    if (mem > base) {
+        munmap(base, mem - base);
+    }
+    munmap(mem + len, base + align - mem);
+    return mem;
+}
+
+//write to every page, for memory that must not be populated before it is bound
+static void prefault(uint8_t *mem, size_t len, size_t page)
+{
+    for (size_t off = 0; off < len; off += page) {
+        ((volatile uint8_t *) mem)[off] = 0;
+    }
+}
+
+static int bind_node(uint8_t *mem, size_t len, int numa_node)
+{
+    unsigned long nodemask = 0;
+    //one bit per node, shifting by a negative or too large node is undefined
+    if (numa_node < 0 || numa_node >= (int) (sizeof(nodemask) * CHAR_BIT)) {
+        errno = EINVAL;
+        return -1;
+    }
+    nodemask |= 1ul << numa_node;
+    return syscall(SYS_mbind, mem, len, RB_MPOL_BIND, &nodemask, sizeof(nodemask) * CHAR_BIT + 1, 0);
+}
+
+rbctx_t* ringbuffer_create(size_t buffer_size, int flags, int numa_node)
+{
+    if (buffer_size == 0 || (flags & RBUF_MIRRORED)) {
+        return NULL;
+    }
+    size_t page = sysconf(_SC_PAGESIZE);
+    int bind = numa_node != RBUF_NUMA_ANY;
+    //pages populated by mmap would already be placed, bound memory is faulted in after mbind
+    int populate = (flags & RBUF_PREFAULT) && !bind ? MAP_POPULATE : 0;
+    int touch = (flags & RBUF_PREFAULT) && !populate;
+
+    size_t len = round_up(buffer_size, page);
+    uint8_t *mem = NULL;
+    if (flags & RBUF_HUGEPAGES) {
+        len = round_up(buffer_size, RB_HUGEPAGE_SIZE);
+        mem = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        if (mem == MAP_FAILED) {
+            //no huge pages reserved, ask for transparent ones
+            mem = map_aligned(len, RB_HUGEPAGE_SIZE);
+            if (mem != NULL) {
+                madvise(mem, len, MADV_HUGEPAGE);
+                touch = flags & RBUF_PREFAULT;
+            }
+        }
+    } else {
+        mem = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+    }
+    if (mem == NULL || mem == MAP_FAILED) {
+        return NULL;
+    }
+
+    rbctx_t *context = aligned_alloc(RBUF_CACHELINE, round_up(sizeof(rbctx_t), RBUF_CACHELINE));
+    if (context == NULL || (bind && bind_node(mem, len, numa_node) != 0)) {
+        free(context);
+        munmap(mem, len);
+        return NULL;
+    }
+    if (touch) {
+        prefault(mem, len, page);
+    }
+    if (ringbuffer_init_flags(context, mem, buffer_size, flags) != SUCCESS) {
+        free(context);
+        munmap(mem, len);
+        return NULL;
+    }
+    context->mapped_len = len;
+    return context;
+}
+
+void ringbuffer_free(rbctx_t *context)
+{
+    uint8_t *mem = context->begin;
+    size_t len = context->mapped_len;
+    ringbuffer_destroy(context);
+    munmap(mem, len);
+    free(context);
+}
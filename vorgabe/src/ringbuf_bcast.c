@@ -0,0 +1,140 @@
+#include "../include/ringbuf_bcast.h"
+#include "ringbuf_ctx.h"
+
+//position of a byte counter in the ring
+static inline uint8_t* at(bcast_rbctx_t *context, uint64_t counter)
+{
+    return context->ring.begin + counter % rb_size(&context->ring);
+}
+
+static uint64_t slowest(bcast_rbctx_t *context)
+{
+    uint64_t min = context->cursors[0];
+    for (size_t i = 1; i < context->nr_subscribers; i++) {
+        if (context->cursors[i] < min) {
+            min = context->cursors[i];
+        }
+    }
+    return min;
+}
+
+//move every subscriber that is in the way of needed bytes behind its oldest messages
+static void overwrite(bcast_rbctx_t *context, size_t needed)
+{
+    rbctx_t *ring = &context->ring;
+    for (size_t i = 0; i < context->nr_subscribers; i++) {
+        while (ring->head - context->cursors[i] + needed > rb_size(ring)) {
+            size_t message_len;
+            size_t prefix_len;
+            uint64_t enqueued_ns;
+            rb_get_len(ring, at(context, context->cursors[i]), &message_len, &prefix_len, &enqueued_ns);
+            context->cursors[i] += prefix_len + message_len;
+            context->lost[i]++;
+        }
+    }
+}
+
+int bcast_ringbuffer_init(bcast_rbctx_t *context, void *buffer_location, size_t buffer_size, int flags,
+                          size_t nr_subscribers, rbcast_mode_t mode)
+{
+    //the eventfds and the latency histogram follow the single read position of rbctx_t,
+    //the subscribers have their own cursors
+    if (nr_subscribers == 0 || (flags & (RBUF_EVENTFD | RBUF_TIMESTAMPS))) {
+        return RINGBUFFER_INVALID;
+    }
+    if (ringbuffer_init_flags(&context->ring, buffer_location, buffer_size, flags) != SUCCESS) {
+        return RINGBUFFER_INVALID;
+    }
+    context->cursors = calloc(nr_subscribers, sizeof(uint64_t));
+    context->lost = calloc(nr_subscribers, sizeof(uint64_t));
+    if (context->cursors == NULL || context->lost == NULL) {
+        bcast_ringbuffer_destroy(context);
+        return RINGBUFFER_INVALID;
+    }
+    context->nr_subscribers = nr_subscribers;
+    context->mode = mode;
+    return SUCCESS;
+}
+
+int bcast_ringbuffer_write(bcast_rbctx_t *context, void *message, size_t message_len)
+{
+    rbctx_t *ring = &context->ring;
+    //the cursors tell full from empty, no byte has to stay free
+    size_t prefix_len = rb_prefix_len(ring, message_len);
+    size_t needed = prefix_len + message_len;
+    if (needed > rb_size(ring)) {
+        return RINGBUFFER_INVALID;
+    }
+
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&ring->mtx);
+    while (ring->head - slowest(context) + needed > rb_size(ring)) {
+        if (context->mode == RBUF_BCAST_OVERWRITE) {
+            overwrite(context, needed);
+            break;
+        }
+        if (rb_wait_not_full(ring, deadline_ns) == ETIMEDOUT) {
+            ring->stats.full++;
+            pthread_mutex_unlock(&ring->mtx);
+            return RINGBUFFER_FULL;
+        }
+    }
+
+    uint8_t *pos = rb_put_len(ring, at(context, ring->head), message_len, prefix_len);
+    rb_put(ring, pos, message, message_len);
+    ring->head += needed;
+    rb_stats_in(&ring->stats, message_len, ring->head - slowest(context));
+
+    //every subscriber has something new
+    rb_notify_readers(ring, 1);
+    pthread_mutex_unlock(&ring->mtx);
+    return SUCCESS;
+}
+
+int bcast_ringbuffer_read(bcast_rbctx_t *context, size_t subscriber, void *buffer, size_t *buffer_len_ptr)
+{
+    rbctx_t *ring = &context->ring;
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&ring->mtx);
+    while (context->cursors[subscriber] == ring->head) {
+        if (rb_wait_not_empty(ring, deadline_ns) == ETIMEDOUT) {
+            ring->stats.empty++;
+            pthread_mutex_unlock(&ring->mtx);
+            return RINGBUFFER_EMPTY;
+        }
+    }
+
+    size_t message_len;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    uint8_t *payload = rb_get_len(ring, at(context, context->cursors[subscriber]), &message_len, &prefix_len, &enqueued_ns);
+    if (message_len > *buffer_len_ptr) {
+        *buffer_len_ptr = message_len;
+        pthread_mutex_unlock(&ring->mtx);
+        return OUTPUT_BUFFER_TOO_SMALL;
+    }
+    rb_get(ring, payload, buffer, message_len);
+    *buffer_len_ptr = message_len;
+    context->cursors[subscriber] += prefix_len + message_len;
+    rb_stats_out(&ring->stats, message_len);
+
+    //only frees space if this was the slowest subscriber, the writer checks again
+    rb_notify_writers(ring);
+    pthread_mutex_unlock(&ring->mtx);
+    return SUCCESS;
+}
+
+void bcast_ringbuffer_lag(bcast_rbctx_t *context, size_t subscriber, uint64_t *behind, uint64_t *lost)
+{
+    pthread_mutex_lock(&context->ring.mtx);
+    *behind = context->ring.head - context->cursors[subscriber];
+    *lost = context->lost[subscriber];
+    pthread_mutex_unlock(&context->ring.mtx);
+}
+
+void bcast_ringbuffer_destroy(bcast_rbctx_t *context)
+{
+    ringbuffer_destroy(&context->ring);
+    free(context->cursors);
+    free(context->lost);
+}
@@ -0,0 +1,441 @@
+#ifndef RINGBUF_CTX_H
+#define RINGBUF_CTX_H
+
+#include "../include/ringbuf.h"
+#include "ringbuf_frame.h"
+#include <sched.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+/*
+ * rbctx_t helpers shared by ringbuf.c and the ringbuffers built on rbctx_t:
+ * copying in and out of the ring, the length prefix framing and waiting
+ * on the conditions.
+ */
+
+#define RB_MAX_VARINT ((sizeof(size_t) * 8 + 6) / 7)
+
+/* fd_state bits */
+#define RB_FD_READ 0x1
+#define RB_FD_WRITE 0x2
+
+/*
+ * Wakes readers waiting on several ringbuffers at once (the lanes of a
+ * ringbuffer_group). Producers only take its mutex while a reader waits.
+ */
+struct rbbell {
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;    //CLOCK_MONOTONIC
+    uint64_t rings;         //bumped under mtx, readers wait until it moves
+    int waiters;            //readers that registered before their last scan
+};
+
+static inline size_t rb_size(rbctx_t *context)
+{
+    return context->end - context->begin;
+}
+
+//copy into the ring at pos, returns the position after the copied bytes
+static inline uint8_t* rb_put(rbctx_t *context, uint8_t *pos, const void *src, size_t n)
+{
+    if (context->flags & RBUF_MIRRORED) {
+        //the bytes after end are the bytes at begin, no split needed
+        memcpy(pos, src, n);
+        pos += n;
+        return pos >= context->end ? pos - rb_size(context) : pos;
+    }
+    return context->begin + rb_frame_put(context->begin, rb_size(context), pos - context->begin, src, n);
+}
+
+//copy out of the ring at pos, returns the position after the copied bytes
+static inline uint8_t* rb_get(rbctx_t *context, uint8_t *pos, void *dst, size_t n)
+{
+    if (context->flags & RBUF_MIRRORED) {
+        memcpy(dst, pos, n);
+        pos += n;
+        return pos >= context->end ? pos - rb_size(context) : pos;
+    }
+    return context->begin + rb_frame_get(context->begin, rb_size(context), pos - context->begin, dst, n);
+}
+
+//n bytes at pos as one segment, or two when they wrap around
+static inline void rb_segments(rbctx_t *context, uint8_t *pos, size_t n, struct iovec vec[2])
+{
+    size_t first = context->end - pos;
+    if ((context->flags & RBUF_MIRRORED) || n <= first) {
+        first = n;
+    }
+    vec[0].iov_base = pos;
+    vec[0].iov_len = first;
+    vec[1].iov_base = context->begin;
+    vec[1].iov_len = n - first;
+}
+
+static inline uint8_t* rb_advance(rbctx_t *context, uint8_t *pos, size_t n)
+{
+    if (context->flags & RBUF_POW2) {
+        return context->begin + ((pos - context->begin + n) & context->mask);
+    }
+    pos += n;
+    return pos >= context->end ? pos - rb_size(context) : pos;
+}
+
+//bytes the ringbuffer can hold, RBUF_POW2 tells full from empty by head - tail and needs no free byte
+static inline size_t rb_capacity(rbctx_t *context)
+{
+    return (context->flags & RBUF_POW2) ? rb_size(context) : rb_size(context) - 1;
+}
+
+static inline size_t rb_space(rbctx_t *context)
+{
+    if (context->flags & RBUF_POW2) {
+        return rb_size(context) - (size_t)(context->head - context->tail);
+    }
+    return rb_frame_space(rb_size(context), context->read - context->begin, context->write - context->begin);
+}
+
+static inline int rb_empty(rbctx_t *context)
+{
+    if (context->flags & RBUF_POW2) {
+        return context->head == context->tail;
+    }
+    return context->read == context->write;
+}
+
+static inline int rb_spill_empty(rbctx_t *context)
+{
+    return context->spill_head == context->spill_tail;
+}
+
+//messages waiting in memory or in the spill file
+static inline int rb_pending(rbctx_t *context)
+{
+    return !rb_empty(context) || !rb_spill_empty(context);
+}
+
+//closed and nothing left to read, reads return RINGBUFFER_CLOSED. An open
+//reservation can still be committed, so it keeps the readers waiting
+static inline int rb_drained(rbctx_t *context)
+{
+    return context->closed && context->reserved == NULL && !rb_pending(context);
+}
+
+//CLOCK_MONOTONIC condition, the clock of all deadlines
+static inline void rb_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static inline void rb_init_sync(rbctx_t *context)
+{
+    pthread_mutex_init(&context->mtx, NULL);
+    rb_cond_init(&context->not_empty);
+    rb_cond_init(&context->not_full);
+    context->read_waiters = 0;
+    context->write_waiters = 0;
+    context->read_wakeups = 0;
+    context->write_wakeups = 0;
+}
+
+/*
+ * rbctx_t without memory, for ringbuffers built from lanes (see rb_init_lane)
+ * that share one mutex: the mutex, the conditions with their waiters and
+ * wakeup counters, the RBUF_WAIT_* strategy of flags and the stats of all
+ * lanes. rb_wait_*, rb_notify_* and ringbuffer_stats work on it,
+ * ringbuffer_destroy releases it.
+ */
+static inline void rb_init_control(rbctx_t *context, int flags)
+{
+    memset(context, 0, sizeof(*context));
+    context->flags = flags & (RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF);
+    context->read_fd = -1;
+    context->write_fd = -1;
+    rb_init_sync(context);
+}
+
+//count a written message, used is the number of bytes stored afterwards. Mutex must be held
+static inline void rb_stats_in(rbstats_t *stats, size_t message_len, size_t used)
+{
+    stats->messages_in++;
+    stats->bytes_in += message_len;
+    if (used > stats->high_water) {
+        stats->high_water = used;
+    }
+}
+
+//count a read message, mutex must be held
+static inline void rb_stats_out(rbstats_t *stats, size_t message_len)
+{
+    stats->messages_out++;
+    stats->bytes_out += message_len;
+}
+
+/*
+ * rbctx_t as memory and framing only, for lanes under the mutex of another
+ * context: no mutex, conditions, eventfds or histogram, so nothing to
+ * destroy. Only the framing flags RBUF_VARINT and RBUF_POW2 apply.
+ */
+static inline int rb_init_lane(rbctx_t *context, void *buffer_location, size_t buffer_size, int flags)
+{
+    if (buffer_size == 0 || (flags & ~(RBUF_VARINT | RBUF_POW2))
+        || ((flags & RBUF_POW2) && (buffer_size & (buffer_size - 1)) != 0)) {
+        return RINGBUFFER_INVALID;
+    }
+    memset(context, 0, sizeof(*context));
+    context->begin = buffer_location;
+    context->read = context->begin;
+    context->write = context->begin;
+    context->end = context->begin + buffer_size;
+    context->mask = buffer_size - 1;
+    context->flags = flags;
+    context->read_fd = -1;
+    context->write_fd = -1;
+    return SUCCESS;
+}
+
+static inline size_t rb_stamp_len(rbctx_t *context)
+{
+    return (context->flags & RBUF_TIMESTAMPS) ? sizeof(uint64_t) : 0;
+}
+
+//bytes of the prefix (length and enqueue time) in front of a message of message_len bytes
+static inline size_t rb_prefix_len(rbctx_t *context, size_t message_len)
+{
+    if (!(context->flags & RBUF_VARINT)) {
+        return sizeof(size_t) + rb_stamp_len(context);
+    }
+    size_t width = 1;
+    while (message_len >= 0x80) {
+        message_len >>= 7;
+        width++;
+    }
+    return width + rb_stamp_len(context);
+}
+
+//write the prefix with exactly prefix_len bytes, returns the position of the message
+static inline uint8_t* rb_put_len(rbctx_t *context, uint8_t *pos, size_t message_len, size_t prefix_len)
+{
+    size_t width = prefix_len - rb_stamp_len(context);
+    if (!(context->flags & RBUF_VARINT)) {
+        pos = rb_put(context, pos, &message_len, sizeof(size_t));
+    } else {
+        //7 bits per byte, the high bit says another byte follows
+        uint8_t prefix[RB_MAX_VARINT];
+        for (size_t i = 0; i + 1 < width; i++) {
+            prefix[i] = (message_len & 0x7f) | 0x80;
+            message_len >>= 7;
+        }
+        prefix[width - 1] = message_len & 0x7f;
+        pos = rb_put(context, pos, prefix, width);
+    }
+    if (context->flags & RBUF_TIMESTAMPS) {
+        uint64_t now = ringbuffer_now_ns();
+        pos = rb_put(context, pos, &now, sizeof(now));
+    }
+    return pos;
+}
+
+//read the prefix at pos, returns the position of the message
+static inline uint8_t* rb_get_len(rbctx_t *context, uint8_t *pos, size_t *message_len, size_t *prefix_len,
+                                  uint64_t *enqueued_ns)
+{
+    if (!(context->flags & RBUF_VARINT)) {
+        *prefix_len = sizeof(size_t);
+        pos = rb_get(context, pos, message_len, sizeof(size_t));
+    } else {
+        *prefix_len = 0;
+        size_t len = 0;
+        unsigned shift = 0;
+        uint8_t byte;
+        do {
+            pos = rb_get(context, pos, &byte, 1);
+            (*prefix_len)++;
+            len |= (size_t)(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        *message_len = len;
+    }
+    *enqueued_ns = 0;
+    if (context->flags & RBUF_TIMESTAMPS) {
+        pos = rb_get(context, pos, enqueued_ns, sizeof(uint64_t));
+        *prefix_len += sizeof(uint64_t);
+    }
+    return pos;
+}
+
+//deadline of the calls without one, RBUF_TIMEOUT seconds from now
+static inline uint64_t rb_default_deadline(void)
+{
+    return ringbuffer_now_ns() + RBUF_TIMEOUT * 1000000000ull;
+}
+
+static inline void rb_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+//on a single CPU nothing moves while we spin, only yielding lets the other side run
+static inline int rb_spin_rounds(void)
+{
+    static int rounds = -1;
+    if (rounds < 0) {
+        rounds = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? RBUF_SPIN_ROUNDS : 0;
+    }
+    return rounds;
+}
+
+/*
+ * Give up the mutex and poll progress (a wakeup counter) until it moves, for
+ * RBUF_SPIN_ROUNDS pauses and then yields sched_yield calls. Returns with
+ * the mutex held, nonzero if progress moved. The polls only decide when to
+ * take the mutex again, the caller checks the ringbuffer under it. The
+ * counter only moves under the mutex, so if it didn't the condition of the
+ * caller still holds and parking can't miss a wakeup.
+ */
+static inline int rb_poll(pthread_mutex_t *mtx, const uint64_t *progress, int yields)
+{
+    uint64_t seen = *progress;
+    int moved = 0;
+    int spins = rb_spin_rounds();
+    if (spins == 0 && yields == 0) {
+        yields = 1;
+    }
+    pthread_mutex_unlock(mtx);
+    for (int i = 0; i < spins && !moved; i++) {
+        rb_cpu_relax();
+        moved = __atomic_load_n(progress, __ATOMIC_RELAXED) != seen;
+    }
+    for (int i = 0; i < yields && !moved; i++) {
+        sched_yield();
+        moved = __atomic_load_n(progress, __ATOMIC_RELAXED) != seen;
+    }
+    pthread_mutex_lock(mtx);
+    return *progress != seen;
+}
+
+/*
+ * Wait for progress (the wakeup counter of the side) with the wait
+ * strategy of the context, mutex must be held. Parking on cond lasts until
+ * signalled, spinning one round of rb_poll. RBUF_NO_WAIT times out right
+ * away, RBUF_WAIT_FOREVER never does. The time waited and timeouts are
+ * counted in the stats of the context.
+ */
+static inline int rb_wait(rbctx_t *context, pthread_cond_t *cond, int *waiters, const uint64_t *progress,
+                          uint64_t deadline_ns)
+{
+    if (deadline_ns == RBUF_NO_WAIT) {
+        return ETIMEDOUT;
+    }
+
+    pthread_mutex_t *mtx = &context->mtx;
+    int check = 0;
+    int parked = !(context->flags & (RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF));
+    uint64_t start_ns = ringbuffer_now_ns();
+    if (!parked) {
+        int yields = (context->flags & RBUF_WAIT_BACKOFF) ? RBUF_YIELD_ROUNDS : 0;
+        if (!rb_poll(mtx, progress, yields)) {
+            //spinners go round again until the deadline, backoff parks
+            parked = (context->flags & RBUF_WAIT_BACKOFF) != 0;
+            if (!parked && deadline_ns != RBUF_WAIT_FOREVER && ringbuffer_now_ns() >= deadline_ns) {
+                check = ETIMEDOUT;
+            }
+        }
+    }
+    if (parked) {
+        (*waiters)++;
+        if (deadline_ns == RBUF_WAIT_FOREVER) {
+            check = pthread_cond_wait(cond, mtx);
+        } else {
+            struct timespec deadline = {
+                .tv_sec = deadline_ns / 1000000000ull,
+                .tv_nsec = deadline_ns % 1000000000ull,
+            };
+            check = pthread_cond_timedwait(cond, mtx, &deadline);
+        }
+        (*waiters)--;
+    }
+    context->stats.wait_ns += ringbuffer_now_ns() - start_ns;
+    if (check == ETIMEDOUT) {
+        context->stats.timeouts++;
+    }
+    return check;
+}
+
+static inline int rb_wait_not_full(rbctx_t *context, uint64_t deadline_ns)
+{
+    return rb_wait(context, &context->not_full, &context->write_waiters, &context->write_wakeups, deadline_ns);
+}
+
+static inline int rb_wait_not_empty(rbctx_t *context, uint64_t deadline_ns)
+{
+    return rb_wait(context, &context->not_empty, &context->read_waiters, &context->read_wakeups, deadline_ns);
+}
+
+/*
+ * Readers only park on an empty ringbuffer and writers only on a full one,
+ * so there is somebody to wake exactly on the empty->non-empty and
+ * full->non-full transitions. Everything else skips the syscall. After
+ * ringbuffer_close every reader has to see the end, read_fd stays set.
+ * Mutex must be held.
+ */
+static inline void rb_notify_readers(rbctx_t *context, int all)
+{
+    __atomic_store_n(&context->read_wakeups, context->read_wakeups + 1, __ATOMIC_RELAXED);
+    if (context->read_waiters > 0) {
+        all || context->closed ? pthread_cond_broadcast(&context->not_empty)
+                               : pthread_cond_signal(&context->not_empty);
+    }
+    if (context->read_fd >= 0 && !(context->fd_state & RB_FD_READ) && (rb_pending(context) || rb_drained(context))) {
+        eventfd_write(context->read_fd, 1);
+        context->fd_state |= RB_FD_READ;
+    }
+    //the lane lock orders this load after the registration of a reader that scanned us too early
+    struct rbbell *bell = context->bell;
+    if (bell != NULL && __atomic_load_n(&bell->waiters, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&bell->mtx);
+        __atomic_store_n(&bell->rings, bell->rings + 1, __ATOMIC_RELAXED);
+        pthread_cond_broadcast(&bell->cond);
+        pthread_mutex_unlock(&bell->mtx);
+    }
+}
+
+static inline void rb_notify_writers(rbctx_t *context)
+{
+    __atomic_store_n(&context->write_wakeups, context->write_wakeups + 1, __ATOMIC_RELAXED);
+    //freed space may fit more than one waiting writer
+    if (context->write_waiters > 0) {
+        pthread_cond_broadcast(&context->not_full);
+    }
+    if (context->read_fd >= 0) {
+        eventfd_t drained;
+        if ((context->fd_state & RB_FD_READ) && !rb_pending(context) && !rb_drained(context)) {
+            eventfd_read(context->read_fd, &drained);
+            context->fd_state &= ~RB_FD_READ;
+        }
+        if (!(context->fd_state & RB_FD_WRITE)) {
+            eventfd_write(context->write_fd, 1);
+            context->fd_state |= RB_FD_WRITE;
+        }
+    }
+}
+
+//a write gave up on a full ringbuffer, mutex must be held
+static inline void rb_full(rbctx_t *context)
+{
+    context->stats.full++;
+    if (context->write_fd >= 0 && (context->fd_state & RB_FD_WRITE)) {
+        eventfd_t drained;
+        eventfd_read(context->write_fd, &drained);
+        context->fd_state &= ~RB_FD_WRITE;
+    }
+}
+
+#endif //RINGBUF_CTX_H
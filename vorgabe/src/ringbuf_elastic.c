@@ -0,0 +1,250 @@
+#include "../include/ringbuf_elastic.h"
+#include "ringbuf_ctx.h"
+
+struct elastic_ring {
+    elastic_ring_t *next;       //the ring created after this one
+    rbctx_t ring;
+};
+
+#define ELASTIC_WAIT_FLAGS (RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF)
+
+static int is_pow2(size_t size)
+{
+    return size != 0 && (size & (size - 1)) == 0;
+}
+
+//list node, context and memory in one allocation, the ring is memory and framing only
+static elastic_ring_t* ring_alloc(size_t size, int flags)
+{
+    elastic_ring_t *node = malloc(sizeof(elastic_ring_t) + size);
+    if (node == NULL) {
+        return NULL;
+    }
+    if (rb_init_lane(&node->ring, node + 1, size, flags & ~ELASTIC_WAIT_FLAGS) != SUCCESS) {
+        free(node);
+        return NULL;
+    }
+    node->next = NULL;
+    return node;
+}
+
+static void ring_free(elastic_ring_t *node)
+{
+    free(node);
+}
+
+//bytes the ring of max_size holds, see rb_capacity
+static size_t max_capacity(elastic_rbctx_t *context)
+{
+    return (context->flags & RBUF_POW2) ? context->max_size : context->max_size - 1;
+}
+
+//size to grow to for a message of needed bytes, at most max_size, 0 if already there
+static size_t grown_size(elastic_rbctx_t *context, size_t needed)
+{
+    size_t size = rb_size(&context->newest->ring);
+    while (size < context->max_size) {
+        size = size * 2 < context->max_size ? size * 2 : context->max_size;
+        if (size - 1 >= needed) {
+            return size;
+        }
+    }
+    return size > rb_size(&context->newest->ring) ? size : 0;
+}
+
+/*
+ * Unlink the rings readers are done with, newest always stays. They go onto
+ * the drained list for free_rings, so they are freed after the mutex is released.
+ */
+static void drop_drained(elastic_rbctx_t *context, elastic_ring_t **drained)
+{
+    while (context->oldest != context->newest && rb_empty(&context->oldest->ring)) {
+        elastic_ring_t *node = context->oldest;
+        context->oldest = node->next;
+        node->next = *drained;
+        *drained = node;
+    }
+}
+
+static void free_rings(elastic_ring_t *node)
+{
+    while (node != NULL) {
+        elastic_ring_t *next = node->next;
+        ring_free(node);
+        node = next;
+    }
+}
+
+/*
+ * Replace the idle ring with one of size bytes. The allocation and the free
+ * happen without the mutex, the swap only if the ring is still the only
+ * one, empty and of the size the decision was made for.
+ */
+static void shrink(elastic_rbctx_t *context, size_t size)
+{
+    elastic_ring_t *smaller = ring_alloc(size, context->flags);
+    if (smaller == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&context->sync.mtx);
+    elastic_ring_t *idle = context->newest;
+    if (context->oldest == idle && rb_empty(&idle->ring) && rb_size(&idle->ring) == size * 2) {
+        context->oldest = smaller;
+        context->newest = smaller;
+        smaller = idle;
+    }
+    pthread_mutex_unlock(&context->sync.mtx);
+    ring_free(smaller);
+}
+
+int elastic_ringbuffer_init(elastic_rbctx_t *context, size_t min_size, size_t max_size, int flags)
+{
+    //with RBUF_POW2 every size it doubles or halves to has to be a power of two
+    if (min_size == 0 || min_size > max_size || (flags & ~(RBUF_VARINT | RBUF_POW2 | ELASTIC_WAIT_FLAGS))
+        || (flags & ELASTIC_WAIT_FLAGS) == ELASTIC_WAIT_FLAGS
+        || ((flags & RBUF_POW2) && (!is_pow2(min_size) || !is_pow2(max_size)))) {
+        return RINGBUFFER_INVALID;
+    }
+    context->oldest = ring_alloc(min_size, flags);
+    if (context->oldest == NULL) {
+        return RINGBUFFER_INVALID;
+    }
+    context->newest = context->oldest;
+    context->min_size = min_size;
+    context->max_size = max_size;
+    context->flags = flags;
+    context->peak = 0;
+    rb_init_control(&context->sync, flags);
+    return SUCCESS;
+}
+
+int elastic_ringbuffer_write(elastic_rbctx_t *context, void *message, size_t message_len)
+{
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&context->sync.mtx);
+
+    size_t prefix_len = rb_prefix_len(&context->newest->ring, message_len);
+    size_t needed = prefix_len + message_len;
+    if (needed > max_capacity(context)) {
+        pthread_mutex_unlock(&context->sync.mtx);
+        return RINGBUFFER_INVALID;
+    }
+    while (rb_space(&context->newest->ring) < needed) {
+        size_t size = grown_size(context, needed);
+        if (size != 0) {
+            //allocate without the lock, readers go on meanwhile
+            elastic_ring_t *newest = context->newest;
+            pthread_mutex_unlock(&context->sync.mtx);
+            elastic_ring_t *node = ring_alloc(size, context->flags);
+            pthread_mutex_lock(&context->sync.mtx);
+            if (node != NULL && newest == context->newest && rb_space(&newest->ring) < needed) {
+                newest->next = node;
+                context->newest = node;
+                context->peak = 0;
+                continue;
+            }
+            if (node != NULL) {
+                //another writer grew it, a reader shrank it or made room meanwhile
+                ring_free(node);
+                continue;
+            }
+        }
+        if (rb_wait_not_full(&context->sync, deadline_ns) == ETIMEDOUT) {
+            context->sync.stats.full++;
+            pthread_mutex_unlock(&context->sync.mtx);
+            return RINGBUFFER_FULL;
+        }
+    }
+
+    rbctx_t *ring = &context->newest->ring;
+    ring->write = rb_put_len(ring, ring->write, message_len, prefix_len);
+    ring->write = rb_put(ring, ring->write, message, message_len);
+    ring->head += needed;
+    size_t used = rb_capacity(ring) - rb_space(ring);
+    if (used > context->peak) {
+        context->peak = used;
+    }
+    rb_stats_in(&context->sync.stats, message_len, used);
+
+    rb_notify_readers(&context->sync, 0);
+    pthread_mutex_unlock(&context->sync.mtx);
+    return SUCCESS;
+}
+
+int elastic_ringbuffer_read(elastic_rbctx_t *context, void *buffer, size_t *buffer_len_ptr)
+{
+    uint64_t deadline_ns = rb_default_deadline();
+    elastic_ring_t *drained = NULL;
+    pthread_mutex_lock(&context->sync.mtx);
+    //a writer that outgrows an empty newest ring leaves it behind, drop it first
+    drop_drained(context, &drained);
+    while (rb_empty(&context->oldest->ring)) {
+        if (rb_wait_not_empty(&context->sync, deadline_ns) == ETIMEDOUT) {
+            context->sync.stats.empty++;
+            pthread_mutex_unlock(&context->sync.mtx);
+            free_rings(drained);
+            return RINGBUFFER_EMPTY;
+        }
+        drop_drained(context, &drained);
+    }
+
+    //everything in a ring was written before the first message of the next one
+    rbctx_t *ring = &context->oldest->ring;
+    size_t message_len;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    uint8_t *payload = rb_get_len(ring, ring->read, &message_len, &prefix_len, &enqueued_ns);
+    if (message_len > *buffer_len_ptr) {
+        *buffer_len_ptr = message_len;
+        pthread_mutex_unlock(&context->sync.mtx);
+        free_rings(drained);
+        return OUTPUT_BUFFER_TOO_SMALL;
+    }
+    ring->read = rb_get(ring, payload, buffer, message_len);
+    ring->tail += prefix_len + message_len;
+    rb_stats_out(&context->sync.stats, message_len);
+    *buffer_len_ptr = message_len;
+
+    drop_drained(context, &drained);
+
+    //idle: never more than a quarter used since it last ran empty, half the size is enough
+    size_t size = rb_size(&context->newest->ring);
+    size_t shrink_to = 0;
+    if (context->oldest == context->newest && rb_empty(&context->newest->ring)) {
+        if (size / 2 >= context->min_size && context->peak < size / 4) {
+            shrink_to = size / 2;
+        }
+        context->peak = 0;
+    }
+
+    rb_notify_writers(&context->sync);
+    pthread_mutex_unlock(&context->sync.mtx);
+    free_rings(drained);
+    if (shrink_to != 0) {
+        shrink(context, shrink_to);
+    }
+    return SUCCESS;
+}
+
+size_t elastic_ringbuffer_size(elastic_rbctx_t *context)
+{
+    pthread_mutex_lock(&context->sync.mtx);
+    size_t size = rb_size(&context->newest->ring);
+    pthread_mutex_unlock(&context->sync.mtx);
+    return size;
+}
+
+void elastic_ringbuffer_stats(elastic_rbctx_t *context, rbstats_t *stats)
+{
+    ringbuffer_stats(&context->sync, stats);
+}
+
+void elastic_ringbuffer_destroy(elastic_rbctx_t *context)
+{
+    while (context->oldest != NULL) {
+        elastic_ring_t *next = context->oldest->next;
+        ring_free(context->oldest);
+        context->oldest = next;
+    }
+    ringbuffer_destroy(&context->sync);
+}
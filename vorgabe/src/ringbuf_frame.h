@@ -0,0 +1,58 @@
+#ifndef RINGBUF_FRAME_H
+#define RINGBUF_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Framing helpers shared by the ringbuffer variants.
+ * A ring is addressed by its first byte and its size, positions are offsets
+ * in [0, size). Copies that cross the end continue at the beginning.
+ */
+
+/**
+ * Copy n bytes into the ring starting at offset pos.
+ *
+ * @return offset directly after the copied bytes
+ */
+static inline size_t rb_frame_put(uint8_t *begin, size_t size, size_t pos, const void *src, size_t n)
+{
+    size_t first = size - pos;
+    if (n < first) {
+        memcpy(begin + pos, src, n);
+        return pos + n;
+    }
+    memcpy(begin + pos, src, first);
+    memcpy(begin, (const uint8_t *)src + first, n - first);
+    return n - first;
+}
+
+/**
+ * Copy n bytes out of the ring starting at offset pos.
+ *
+ * @return offset directly after the copied bytes
+ */
+static inline size_t rb_frame_get(const uint8_t *begin, size_t size, size_t pos, void *dst, size_t n)
+{
+    size_t first = size - pos;
+    if (n < first) {
+        memcpy(dst, begin + pos, n);
+        return pos + n;
+    }
+    memcpy(dst, begin + pos, first);
+    memcpy((uint8_t *)dst + first, begin, n - first);
+    return n - first;
+}
+
+/**
+ * Number of bytes that can be written between read and write offset.
+ * One byte always stays free so that read == write means empty.
+ */
+static inline size_t rb_frame_space(size_t size, size_t read, size_t write)
+{
+    size_t used = write >= read ? write - read : size - (read - write);
+    return size - used - 1;
+}
+
+#endif //RINGBUF_FRAME_H
@@ -0,0 +1,183 @@
+#include "../include/ringbuf_group.h"
+#include "ringbuf_ctx.h"
+
+/* one read attempt on a lane, used for the single and the batch read */
+typedef struct {
+    void* buffer;
+    size_t* buffer_len;
+    size_t* offsets;
+    size_t max_messages;
+    size_t* nr_read;
+} group_read_t;
+
+static int lane_read(rbctx_t *lane, group_read_t *req, uint64_t deadline_ns)
+{
+    if (req->offsets == NULL) {
+        return ringbuffer_read_until(lane, req->buffer, req->buffer_len, deadline_ns);
+    }
+    return ringbuffer_read_batch_until(lane, req->buffer, *req->buffer_len, req->offsets,
+                                       req->max_messages, req->nr_read, deadline_ns);
+}
+
+//lane a read looks at first
+static size_t first_lane(rbgroup_t *group)
+{
+    if (group->policy == RBUF_GROUP_OCCUPANCY) {
+        size_t best = 0;
+        size_t best_used = 0;
+        //a snapshot is enough to pick a lane, don't take every mutex for it
+        for (size_t i = 0; i < group->nr_lanes; i++) {
+            rbctx_t *lane = &group->lanes[i];
+            size_t used = __atomic_load_n(&lane->head, __ATOMIC_RELAXED) - __atomic_load_n(&lane->tail, __ATOMIC_RELAXED);
+            if (used > best_used) {
+                best = i;
+                best_used = used;
+            }
+        }
+        return best;
+    }
+    return atomic_fetch_add_explicit(&group->next, 1, memory_order_relaxed) % group->nr_lanes;
+}
+
+//try every lane once without waiting, closed and drained lanes are skipped
+static int group_scan(rbgroup_t *group, group_read_t *req)
+{
+    size_t first = first_lane(group);
+    int ret = RINGBUFFER_CLOSED;
+    for (size_t i = 0; i < group->nr_lanes; i++) {
+        int lane_ret = lane_read(&group->lanes[(first + i) % group->nr_lanes], req, RBUF_NO_WAIT);
+        if (lane_ret == RINGBUFFER_EMPTY) {
+            ret = RINGBUFFER_EMPTY;
+        } else if (lane_ret != RINGBUFFER_CLOSED) {
+            return lane_ret;
+        }
+    }
+    return ret;
+}
+
+//park until a lane rang the bell since seen was read
+static int bell_wait(struct rbbell *bell, uint64_t seen, uint64_t deadline_ns)
+{
+    struct timespec deadline = {
+        .tv_sec = deadline_ns / 1000000000ull,
+        .tv_nsec = deadline_ns % 1000000000ull,
+    };
+    int check = 0;
+    pthread_mutex_lock(&bell->mtx);
+    while (bell->rings == seen && check != ETIMEDOUT) {
+        check = pthread_cond_timedwait(&bell->cond, &bell->mtx, &deadline);
+    }
+    pthread_mutex_unlock(&bell->mtx);
+    return check;
+}
+
+/*
+ * Scan all lanes, when they are empty register on the bell, scan again
+ * and park until a lane gets a message or is closed. The group is closed
+ * once all lanes are closed and drained.
+ */
+static int group_read(rbgroup_t *group, group_read_t *req)
+{
+    int ret = group_scan(group, req);
+    if (ret != RINGBUFFER_EMPTY) {
+        return ret;
+    }
+
+    uint64_t deadline_ns = rb_default_deadline();
+    struct rbbell *bell = group->bell;
+    __atomic_add_fetch(&bell->waiters, 1, __ATOMIC_SEQ_CST);
+    while (1) {
+        uint64_t seen = __atomic_load_n(&bell->rings, __ATOMIC_SEQ_CST);
+        ret = group_scan(group, req);
+        if (ret != RINGBUFFER_EMPTY || bell_wait(bell, seen, deadline_ns) == ETIMEDOUT) {
+            break;
+        }
+    }
+    __atomic_sub_fetch(&bell->waiters, 1, __ATOMIC_SEQ_CST);
+    return ret;
+}
+
+//a lane has to hold a message of 1 byte and its prefix, one byte stays free without RBUF_POW2
+static size_t min_lane_size(int flags)
+{
+    size_t prefix_len = (flags & RBUF_VARINT) ? 1 : sizeof(size_t);
+    if (flags & RBUF_TIMESTAMPS) {
+        prefix_len += sizeof(uint64_t);
+    }
+    return prefix_len + 1 + ((flags & RBUF_POW2) ? 0 : 1);
+}
+
+int ringbuffer_group_init(rbgroup_t *group, size_t nr_lanes, size_t lane_size, int flags, rbgroup_policy_t policy)
+{
+    if (nr_lanes == 0 || lane_size < min_lane_size(flags) || nr_lanes > SIZE_MAX / lane_size) {
+        return RINGBUFFER_INVALID;
+    }
+    group->lanes = malloc(nr_lanes * sizeof(rbctx_t));
+    group->memory = malloc(nr_lanes * lane_size);
+    group->bell = malloc(sizeof(struct rbbell));
+    if (group->lanes == NULL || group->memory == NULL || group->bell == NULL) {
+        free(group->lanes);
+        free(group->memory);
+        free(group->bell);
+        return RINGBUFFER_INVALID;
+    }
+
+    for (size_t i = 0; i < nr_lanes; i++) {
+        if (ringbuffer_init_flags(&group->lanes[i], (uint8_t*)group->memory + i * lane_size, lane_size, flags) != SUCCESS) {
+            for (size_t j = 0; j < i; j++) {
+                ringbuffer_destroy(&group->lanes[j]);
+            }
+            free(group->lanes);
+            free(group->memory);
+            free(group->bell);
+            return RINGBUFFER_INVALID;
+        }
+        group->lanes[i].bell = group->bell;
+    }
+
+    pthread_mutex_init(&group->bell->mtx, NULL);
+    rb_cond_init(&group->bell->cond);
+    group->bell->rings = 0;
+    group->bell->waiters = 0;
+    group->nr_lanes = nr_lanes;
+    group->policy = policy;
+    atomic_init(&group->next, 0);
+    return SUCCESS;
+}
+
+rbctx_t* ringbuffer_group_lane(rbgroup_t *group, size_t producer)
+{
+    return &group->lanes[producer % group->nr_lanes];
+}
+
+void ringbuffer_group_close(rbgroup_t *group)
+{
+    for (size_t i = 0; i < group->nr_lanes; i++) {
+        ringbuffer_close(&group->lanes[i]);
+    }
+}
+
+int ringbuffer_group_read(rbgroup_t *group, void *buffer, size_t *buffer_len_ptr)
+{
+    group_read_t req = {buffer, buffer_len_ptr, NULL, 0, NULL};
+    return group_read(group, &req);
+}
+
+int ringbuffer_group_read_batch(rbgroup_t *group, void *buffer, size_t buffer_len,
+                                size_t *offsets, size_t max_messages, size_t *nr_read)
+{
+    group_read_t req = {buffer, &buffer_len, offsets, max_messages, nr_read};
+    return group_read(group, &req);
+}
+
+void ringbuffer_group_destroy(rbgroup_t *group)
+{
+    for (size_t i = 0; i < group->nr_lanes; i++) {
+        ringbuffer_destroy(&group->lanes[i]);
+    }
+    pthread_mutex_destroy(&group->bell->mtx);
+    pthread_cond_destroy(&group->bell->cond);
+    free(group->lanes);
+    free(group->memory);
+    free(group->bell);
+}
@@ -0,0 +1,114 @@
+#include "../include/ringbuf_mpmc.h"
+
+typedef struct {
+    _Atomic size_t seq;
+    _Atomic size_t len;
+} mpmc_slot_t;
+
+static inline mpmc_slot_t *slot_at(mpmc_rbctx_t *context, size_t pos)
+{
+    return (mpmc_slot_t *)(context->slots + (pos & context->mask) * context->stride);
+}
+
+int mpmc_ringbuffer_init(mpmc_rbctx_t *context, void *buffer_location, size_t buffer_size, size_t max_message_len)
+{
+    //round slots up to whole cache lines so neighbours don't share one
+    size_t stride = sizeof(mpmc_slot_t) + max_message_len;
+    stride = (stride + RBUF_CACHELINE - 1) & ~(size_t)(RBUF_CACHELINE - 1);
+
+    size_t nr_slots = 1;
+    while (nr_slots * 2 <= buffer_size / stride) {
+        nr_slots *= 2;
+    }
+    if (nr_slots < 2 || nr_slots > buffer_size / stride) {
+        return RINGBUFFER_INVALID;
+    }
+
+    context->slots = buffer_location;
+    context->mask = nr_slots - 1;
+    context->slot_size = max_message_len;
+    context->stride = stride;
+    for (size_t i = 0; i < nr_slots; i++) {
+        atomic_init(&slot_at(context, i)->seq, i);
+        atomic_init(&slot_at(context, i)->len, 0);
+    }
+    atomic_init(&context->enqueue_pos, 0);
+    atomic_init(&context->dequeue_pos, 0);
+    return SUCCESS;
+}
+
+int mpmc_ringbuffer_write(mpmc_rbctx_t *context, void *message, size_t message_len)
+{
+    if (message_len > context->slot_size) {
+        return RINGBUFFER_INVALID;
+    }
+
+    size_t pos = atomic_load_explicit(&context->enqueue_pos, memory_order_relaxed);
+    mpmc_slot_t *slot;
+    while (1) {
+        slot = slot_at(context, pos);
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            //slot is free for this ticket, try to claim it
+            if (atomic_compare_exchange_weak_explicit(&context->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            //slot still holds the message from one lap ago
+            return RINGBUFFER_FULL;
+        } else {
+            pos = atomic_load_explicit(&context->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(slot + 1, message, message_len);
+    atomic_store_explicit(&slot->len, message_len, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return SUCCESS;
+}
+
+int mpmc_ringbuffer_read(mpmc_rbctx_t *context, void *buffer, size_t *buffer_len)
+{
+    size_t pos = atomic_load_explicit(&context->dequeue_pos, memory_order_relaxed);
+    mpmc_slot_t *slot;
+    size_t message_len;
+    while (1) {
+        slot = slot_at(context, pos);
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            //check the size before claiming so the message stays if it doesn't fit
+            message_len = atomic_load_explicit(&slot->len, memory_order_relaxed);
+            if (message_len > *buffer_len) {
+                if (pos == atomic_load_explicit(&context->dequeue_pos, memory_order_relaxed)) {
+                    *buffer_len = message_len;
+                    return OUTPUT_BUFFER_TOO_SMALL;
+                }
+                pos = atomic_load_explicit(&context->dequeue_pos, memory_order_relaxed);
+                continue;
+            }
+            if (atomic_compare_exchange_weak_explicit(&context->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return RINGBUFFER_EMPTY;
+        } else {
+            pos = atomic_load_explicit(&context->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(buffer, slot + 1, message_len);
+    *buffer_len = message_len;
+    //hand the slot to the producer of the next lap
+    atomic_store_explicit(&slot->seq, pos + context->mask + 1, memory_order_release);
+    return SUCCESS;
+}
+
+void mpmc_ringbuffer_destroy(mpmc_rbctx_t *context)
+{
+    context->slots = NULL;
+    context->mask = 0;
+}
@@ -0,0 +1,223 @@
+#include "../include/ringbuf_persist.h"
+#include "ringbuf_ctx.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define PERSIST_FLAGS (RBUF_VARINT | RBUF_POW2)
+
+//msync the pages of n bytes at pos, n may wrap around the end of the ring
+static void persist_sync(persist_rbctx_t *context, uint8_t *pos, size_t n)
+{
+    struct iovec vec[2];
+    rb_segments(&context->ring, pos, n, vec);
+    for (int i = 0; i < 2; i++) {
+        if (vec[i].iov_len == 0) {
+            continue;
+        }
+        uintptr_t start = (uintptr_t) vec[i].iov_base / context->page * context->page;
+        msync((void *) start, (uintptr_t) vec[i].iov_base + vec[i].iov_len - start, MS_SYNC);
+    }
+}
+
+//move a cursor in the file, the commit point of a write or read
+static void persist_publish(persist_rbctx_t *context, uint64_t *cursor, uint64_t value)
+{
+    __atomic_store_n(cursor, value, __ATOMIC_RELEASE);
+    if (context->durable) {
+        msync(context->hdr, context->page, MS_SYNC);
+    }
+}
+
+//fsync the directory of path, so the name of a new file survives power loss too
+static void persist_sync_dir(const char *path)
+{
+    char dir[PATH_MAX];
+    const char *slash = strrchr(path, '/');
+    if (slash == NULL) {
+        strcpy(dir, ".");
+    } else if ((size_t) (slash - path) < sizeof(dir)) {
+        size_t len = slash == path ? 1 : (size_t) (slash - path);
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    } else {
+        return;
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/*
+ * Create the file under a temporary name, write and sync the header and
+ * only then link it to path, so path never names a file without a complete
+ * header. Unlike rename, link fails with EEXIST instead of replacing a file
+ * another process created in the meantime. The temporary file is locked
+ * before anyone can open it under path.
+ * Returns the locked fd or -1 with errno set.
+ */
+static int persist_create(persist_rbctx_t *context, const char *path, size_t buffer_size, int flags, int durable)
+{
+    char tmp[PATH_MAX];
+    if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path) >= (int) sizeof(tmp)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = mkstemp(tmp);
+    if (fd < 0) {
+        return -1;
+    }
+    persist_rbhdr_t hdr = {
+        .magic = RBUF_PERSIST_MAGIC,
+        .size = buffer_size,
+        .flags = flags,
+        .head = 0,
+        .tail = 0,
+    };
+    int ok = flock(fd, LOCK_EX | LOCK_NB) == 0 && ftruncate(fd, context->map_len) == 0
+             && pwrite(fd, &hdr, sizeof(hdr), 0) == (ssize_t) sizeof(hdr) && fsync(fd) == 0
+             && link(tmp, path) == 0;
+    int error = errno;
+    unlink(tmp);
+    if (!ok) {
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    if (durable) {
+        persist_sync_dir(path);
+    }
+    return fd;
+}
+
+int persist_ringbuffer_open(persist_rbctx_t *context, const char *path, size_t buffer_size, int flags, int durable)
+{
+    if (buffer_size == 0 || (flags & ~PERSIST_FLAGS)) {
+        return RINGBUFFER_INVALID;
+    }
+    context->page = sysconf(_SC_PAGESIZE);
+    context->map_len = context->page + buffer_size;
+    int fd = open(path, O_RDWR);
+    if (fd < 0 && errno == ENOENT) {
+        fd = persist_create(context, path, buffer_size, flags, durable);
+        if (fd < 0 && errno == EEXIST) {
+            //another process created it first
+            fd = open(path, O_RDWR);
+        }
+    }
+    if (fd < 0) {
+        return RINGBUFFER_INVALID;
+    }
+    //one process uses the file at a time, the lock lasts until persist_ringbuffer_close
+    struct stat st;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0 || fstat(fd, &st) != 0 || (size_t) st.st_size != context->map_len) {
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    uint8_t *base = mmap(NULL, context->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    context->hdr = (persist_rbhdr_t *) base;
+    context->durable = durable;
+
+    persist_rbhdr_t *hdr = context->hdr;
+    if (hdr->magic != RBUF_PERSIST_MAGIC || hdr->size != buffer_size || hdr->flags != (uint64_t) flags
+        || hdr->head - hdr->tail > buffer_size
+        || ringbuffer_init_flags(&context->ring, base + context->page, buffer_size, flags) != SUCCESS) {
+        munmap(base, context->map_len);
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    context->fd = fd;
+    //the read and write positions follow from the cursors in both modes
+    rbctx_t *ring = &context->ring;
+    ring->head = hdr->head;
+    ring->tail = hdr->tail;
+    ring->write = ring->begin + ring->head % buffer_size;
+    ring->read = ring->begin + ring->tail % buffer_size;
+    return SUCCESS;
+}
+
+int persist_ringbuffer_write(persist_rbctx_t *context, void *message, size_t message_len)
+{
+    rbctx_t *ring = &context->ring;
+    size_t prefix_len = rb_prefix_len(ring, message_len);
+    uint64_t deadline_ns = rb_default_deadline();
+
+    pthread_mutex_lock(&ring->mtx);
+    while (rb_space(ring) < message_len + prefix_len) {
+        if (rb_wait_not_full(ring, deadline_ns) == ETIMEDOUT) {
+            ring->stats.full++;
+            pthread_mutex_unlock(&ring->mtx);
+            return RINGBUFFER_FULL;
+        }
+    }
+
+    uint8_t *start = ring->write;
+    ring->write = rb_put_len(ring, ring->write, message_len, prefix_len);
+    ring->write = rb_put(ring, ring->write, message, message_len);
+    ring->head += prefix_len + message_len;
+    rb_stats_in(&ring->stats, message_len, ring->head - ring->tail);
+    //the message has to be in the file before head says so
+    if (context->durable) {
+        persist_sync(context, start, prefix_len + message_len);
+    }
+    persist_publish(context, &context->hdr->head, ring->head);
+
+    rb_notify_readers(ring, 0);
+    pthread_mutex_unlock(&ring->mtx);
+    return SUCCESS;
+}
+
+int persist_ringbuffer_read(persist_rbctx_t *context, void *buffer, size_t *buffer_len_ptr)
+{
+    rbctx_t *ring = &context->ring;
+    uint64_t deadline_ns = rb_default_deadline();
+
+    pthread_mutex_lock(&ring->mtx);
+    while (rb_empty(ring)) {
+        if (rb_wait_not_empty(ring, deadline_ns) == ETIMEDOUT) {
+            ring->stats.empty++;
+            pthread_mutex_unlock(&ring->mtx);
+            return RINGBUFFER_EMPTY;
+        }
+    }
+
+    size_t message_len;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    uint8_t *payload = rb_get_len(ring, ring->read, &message_len, &prefix_len, &enqueued_ns);
+    if (message_len > *buffer_len_ptr) {
+        *buffer_len_ptr = message_len;
+        pthread_mutex_unlock(&ring->mtx);
+        return OUTPUT_BUFFER_TOO_SMALL;
+    }
+    ring->read = rb_get(ring, payload, buffer, message_len);
+    ring->tail += prefix_len + message_len;
+    rb_stats_out(&ring->stats, message_len);
+    *buffer_len_ptr = message_len;
+    persist_publish(context, &context->hdr->tail, ring->tail);
+
+    rb_notify_writers(ring);
+    pthread_mutex_unlock(&ring->mtx);
+    return SUCCESS;
+}
+
+void persist_ringbuffer_close(persist_rbctx_t *context)
+{
+    ringbuffer_destroy(&context->ring);
+    munmap(context->hdr, context->map_len);
+    //releases the flock
+    close(context->fd);
+}
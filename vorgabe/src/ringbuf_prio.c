@@ -0,0 +1,164 @@
+#include "../include/ringbuf_prio.h"
+#include "ringbuf_ctx.h"
+
+#define PRIO_WAIT_FLAGS (RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF)
+
+//lane the next read serves, nr_lanes if all are empty
+static size_t pick_lane(prio_rbctx_t *context)
+{
+    size_t best = context->nr_lanes;
+    for (size_t i = 0; i < context->nr_lanes; i++) {
+        if (rb_empty(&context->lanes[i])) {
+            continue;
+        }
+        if (context->policy == RBUF_PRIO_STRICT) {
+            return i;
+        }
+        if (best == context->nr_lanes ||
+            context->credits[i] + context->weights[i] > context->credits[best] + context->weights[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/*
+ * Smooth weighted round-robin: every lane with messages earns its weight,
+ * the served lane pays the weights of all of them. Over time every lane is
+ * served in proportion to its weight, without long runs of a single lane.
+ */
+static void charge_lane(prio_rbctx_t *context, size_t served)
+{
+    if (context->policy != RBUF_PRIO_WEIGHTED) {
+        return;
+    }
+    long total = 0;
+    for (size_t i = 0; i < context->nr_lanes; i++) {
+        if (i == served || !rb_empty(&context->lanes[i])) {
+            context->credits[i] += context->weights[i];
+            total += context->weights[i];
+        }
+    }
+    context->credits[served] -= total;
+}
+
+static int init_failed(prio_rbctx_t *context)
+{
+    free(context->lanes);
+    free(context->weights);
+    free(context->credits);
+    return RINGBUFFER_INVALID;
+}
+
+int prio_ringbuffer_init(prio_rbctx_t *context, void *buffer_location, const size_t *lane_sizes,
+                         const unsigned *weights, size_t nr_lanes, int flags, rbprio_policy_t policy)
+{
+    if (nr_lanes == 0 || (policy == RBUF_PRIO_WEIGHTED && weights == NULL)
+        || (flags & PRIO_WAIT_FLAGS) == PRIO_WAIT_FLAGS) {
+        return RINGBUFFER_INVALID;
+    }
+    context->lanes = malloc(nr_lanes * sizeof(rbctx_t));
+    context->weights = calloc(nr_lanes, sizeof(unsigned));
+    context->credits = calloc(nr_lanes, sizeof(long));
+    if (context->lanes == NULL || context->weights == NULL || context->credits == NULL) {
+        return init_failed(context);
+    }
+
+    uint8_t *lane_begin = buffer_location;
+    for (size_t i = 0; i < nr_lanes; i++) {
+        if ((policy == RBUF_PRIO_WEIGHTED && weights[i] == 0) ||
+            rb_init_lane(&context->lanes[i], lane_begin, lane_sizes[i], flags & ~PRIO_WAIT_FLAGS) != SUCCESS) {
+            return init_failed(context);
+        }
+        context->weights[i] = weights != NULL ? weights[i] : 1;
+        lane_begin += lane_sizes[i];
+    }
+    context->nr_lanes = nr_lanes;
+    context->policy = policy;
+    rb_init_control(&context->sync, flags);
+    return SUCCESS;
+}
+
+int prio_ringbuffer_write(prio_rbctx_t *context, size_t prio, void *message, size_t message_len)
+{
+    if (prio >= context->nr_lanes) {
+        return RINGBUFFER_INVALID;
+    }
+    rbctx_t *lane = &context->lanes[prio];
+    size_t prefix_len = rb_prefix_len(lane, message_len);
+    uint64_t deadline_ns = rb_default_deadline();
+
+    pthread_mutex_lock(&context->sync.mtx);
+    while (rb_space(lane) < message_len + prefix_len) {
+        if (rb_wait_not_full(&context->sync, deadline_ns) == ETIMEDOUT) {
+            context->sync.stats.full++;
+            pthread_mutex_unlock(&context->sync.mtx);
+            return RINGBUFFER_FULL;
+        }
+    }
+
+    lane->write = rb_put_len(lane, lane->write, message_len, prefix_len);
+    lane->write = rb_put(lane, lane->write, message, message_len);
+    lane->head += prefix_len + message_len;
+    size_t used = 0;
+    for (size_t i = 0; i < context->nr_lanes; i++) {
+        used += context->lanes[i].head - context->lanes[i].tail;
+    }
+    rb_stats_in(&context->sync.stats, message_len, used);
+
+    rb_notify_readers(&context->sync, 0);
+    pthread_mutex_unlock(&context->sync.mtx);
+    return SUCCESS;
+}
+
+int prio_ringbuffer_read(prio_rbctx_t *context, void *buffer, size_t *buffer_len_ptr, size_t *prio)
+{
+    uint64_t deadline_ns = rb_default_deadline();
+    pthread_mutex_lock(&context->sync.mtx);
+    size_t served;
+    while ((served = pick_lane(context)) == context->nr_lanes) {
+        if (rb_wait_not_empty(&context->sync, deadline_ns) == ETIMEDOUT) {
+            context->sync.stats.empty++;
+            pthread_mutex_unlock(&context->sync.mtx);
+            return RINGBUFFER_EMPTY;
+        }
+    }
+
+    rbctx_t *lane = &context->lanes[served];
+    size_t message_len;
+    size_t prefix_len;
+    uint64_t enqueued_ns;
+    uint8_t *payload = rb_get_len(lane, lane->read, &message_len, &prefix_len, &enqueued_ns);
+    if (message_len > *buffer_len_ptr) {
+        *buffer_len_ptr = message_len;
+        pthread_mutex_unlock(&context->sync.mtx);
+        return OUTPUT_BUFFER_TOO_SMALL;
+    }
+    charge_lane(context, served);
+    lane->read = rb_get(lane, payload, buffer, message_len);
+    lane->tail += prefix_len + message_len;
+    rb_stats_out(&context->sync.stats, message_len);
+    *buffer_len_ptr = message_len;
+    if (prio != NULL) {
+        *prio = served;
+    }
+
+    //writers of all lanes share the condition, rb_notify_writers wakes all of them
+    rb_notify_writers(&context->sync);
+    pthread_mutex_unlock(&context->sync.mtx);
+    return SUCCESS;
+}
+
+void prio_ringbuffer_stats(prio_rbctx_t *context, rbstats_t *stats)
+{
+    ringbuffer_stats(&context->sync, stats);
+}
+
+void prio_ringbuffer_destroy(prio_rbctx_t *context)
+{
+    //the lanes are only memory, there is nothing to destroy in them
+    ringbuffer_destroy(&context->sync);
+    free(context->lanes);
+    free(context->weights);
+    free(context->credits);
+}
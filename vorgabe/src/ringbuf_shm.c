@@ -0,0 +1,206 @@
+#include "../include/ringbuf_shm.h"
+#include "ringbuf_frame.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//message memory starts at the first cache line after the control block
+#define CTRL_LEN ((sizeof(shm_rbctrl_t) + RBUF_CACHELINE - 1) & ~(size_t)(RBUF_CACHELINE - 1))
+
+/*
+ * A process died while holding the mutex. It can only have been in the
+ * middle of a copy, head/tail still describe complete messages, so the
+ * state is consistent as it is.
+ */
+static int recover(shm_rbctrl_t *ctrl, int check)
+{
+    if (check == EOWNERDEAD) {
+        pthread_mutex_consistent(&ctrl->mtx);
+        return 0;
+    }
+    return check;
+}
+
+static int shm_lock(shm_rbctrl_t *ctrl)
+{
+    return recover(ctrl, pthread_mutex_lock(&ctrl->mtx));
+}
+
+//wait a slice on cond, mutex must be held. Returns ETIMEDOUT once the deadline passed
+static int shm_wait(shm_rbctrl_t *ctrl, pthread_cond_t *cond, uint64_t deadline_ns)
+{
+    uint64_t now = ringbuffer_now_ns();
+    if (now >= deadline_ns) {
+        return ETIMEDOUT;
+    }
+    uint64_t until = now + RBUF_SHM_POLL_NS < deadline_ns ? now + RBUF_SHM_POLL_NS : deadline_ns;
+    struct timespec deadline = {
+        .tv_sec = until / 1000000000ull,
+        .tv_nsec = until % 1000000000ull,
+    };
+    int check = recover(ctrl, pthread_cond_timedwait(cond, &ctrl->mtx, &deadline));
+    return check == ETIMEDOUT ? 0 : check;
+}
+
+static int map(shm_rbctx_t *context, int fd, size_t map_len)
+{
+    void *base = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return RINGBUFFER_INVALID;
+    }
+    context->ctrl = base;
+    context->begin = (uint8_t*)base + CTRL_LEN;
+    context->map_len = map_len;
+    return SUCCESS;
+}
+
+int shm_ringbuffer_create(shm_rbctx_t *context, const char *name, size_t buffer_size)
+{
+    if (buffer_size == 0 || strlen(name) >= sizeof(context->name)) {
+        return RINGBUFFER_INVALID;
+    }
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return RINGBUFFER_INVALID;
+    }
+    if (ftruncate(fd, CTRL_LEN + buffer_size) != 0 || map(context, fd, CTRL_LEN + buffer_size) != SUCCESS) {
+        shm_unlink(name);
+        return RINGBUFFER_INVALID;
+    }
+    strcpy(context->name, name);
+    context->owner = 1;
+
+    shm_rbctrl_t *ctrl = context->ctrl;
+    ctrl->size = buffer_size;
+    ctrl->head = 0;
+    ctrl->tail = 0;
+
+    pthread_mutexattr_t mattr;
+    pthread_mutexattr_init(&mattr);
+    pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mattr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&ctrl->mtx, &mattr);
+    pthread_mutexattr_destroy(&mattr);
+
+    pthread_condattr_t cattr;
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&ctrl->not_empty, &cattr);
+    pthread_cond_init(&ctrl->not_full, &cattr);
+    pthread_condattr_destroy(&cattr);
+
+    //openers check the magic last, after everything else is set up
+    __atomic_store_n(&ctrl->magic, RBUF_SHM_MAGIC, __ATOMIC_RELEASE);
+    return SUCCESS;
+}
+
+int shm_ringbuffer_open(shm_rbctx_t *context, const char *name)
+{
+    if (strlen(name) >= sizeof(context->name)) {
+        return RINGBUFFER_INVALID;
+    }
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return RINGBUFFER_INVALID;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size <= CTRL_LEN) {
+        close(fd);
+        return RINGBUFFER_INVALID;
+    }
+    if (map(context, fd, st.st_size) != SUCCESS) {
+        return RINGBUFFER_INVALID;
+    }
+    if (__atomic_load_n(&context->ctrl->magic, __ATOMIC_ACQUIRE) != RBUF_SHM_MAGIC ||
+        context->ctrl->size != context->map_len - CTRL_LEN) {
+        munmap(context->ctrl, context->map_len);
+        return RINGBUFFER_INVALID;
+    }
+    strcpy(context->name, name);
+    context->owner = 0;
+    return SUCCESS;
+}
+
+int shm_ringbuffer_write(shm_rbctx_t *context, void *message, size_t message_len)
+{
+    shm_rbctrl_t *ctrl = context->ctrl;
+    size_t needed = message_len + sizeof(size_t);
+    uint64_t deadline_ns = ringbuffer_now_ns() + RBUF_TIMEOUT * 1000000000ull;
+
+    if (shm_lock(ctrl) != 0) {
+        return RINGBUFFER_INVALID;
+    }
+    while (ctrl->size - (ctrl->head - ctrl->tail) < needed) {
+        int check = shm_wait(ctrl, &ctrl->not_full, deadline_ns);
+        if (check != 0) {
+            if (check == ETIMEDOUT) {
+                pthread_mutex_unlock(&ctrl->mtx);
+            }
+            return check == ETIMEDOUT ? RINGBUFFER_FULL : RINGBUFFER_INVALID;
+        }
+    }
+
+    //copy first, publishing head afterwards is what makes the message visible
+    size_t pos = ctrl->head % ctrl->size;
+    pos = rb_frame_put(context->begin, ctrl->size, pos, &message_len, sizeof(size_t));
+    rb_frame_put(context->begin, ctrl->size, pos, message, message_len);
+    ctrl->head += needed;
+
+    pthread_cond_signal(&ctrl->not_empty);
+    pthread_mutex_unlock(&ctrl->mtx);
+    return SUCCESS;
+}
+
+int shm_ringbuffer_read(shm_rbctx_t *context, void *buffer, size_t *buffer_len_ptr)
+{
+    shm_rbctrl_t *ctrl = context->ctrl;
+    uint64_t deadline_ns = ringbuffer_now_ns() + RBUF_TIMEOUT * 1000000000ull;
+
+    if (shm_lock(ctrl) != 0) {
+        return RINGBUFFER_INVALID;
+    }
+    while (ctrl->head == ctrl->tail) {
+        int check = shm_wait(ctrl, &ctrl->not_empty, deadline_ns);
+        if (check != 0) {
+            if (check == ETIMEDOUT) {
+                pthread_mutex_unlock(&ctrl->mtx);
+            }
+            return check == ETIMEDOUT ? RINGBUFFER_EMPTY : RINGBUFFER_INVALID;
+        }
+    }
+
+    size_t message_len;
+    size_t pos = ctrl->tail % ctrl->size;
+    pos = rb_frame_get(context->begin, ctrl->size, pos, &message_len, sizeof(size_t));
+    if (message_len > *buffer_len_ptr) {
+        *buffer_len_ptr = message_len;
+        pthread_mutex_unlock(&ctrl->mtx);
+        return OUTPUT_BUFFER_TOO_SMALL;
+    }
+    rb_frame_get(context->begin, ctrl->size, pos, buffer, message_len);
+    *buffer_len_ptr = message_len;
+    ctrl->tail += message_len + sizeof(size_t);
+
+    pthread_cond_broadcast(&ctrl->not_full);
+    pthread_mutex_unlock(&ctrl->mtx);
+    return SUCCESS;
+}
+
+void shm_ringbuffer_close(shm_rbctx_t *context)
+{
+    munmap(context->ctrl, context->map_len);
+}
+
+void shm_ringbuffer_destroy(shm_rbctx_t *context)
+{
+    if (context->owner) {
+        pthread_mutex_destroy(&context->ctrl->mtx);
+        pthread_cond_destroy(&context->ctrl->not_empty);
+        pthread_cond_destroy(&context->ctrl->not_full);
+        shm_unlink(context->name);
+    }
+    shm_ringbuffer_close(context);
+}
@@ -0,0 +1,66 @@
+#include "../include/ringbuf_spsc.h"
+#include "ringbuf_frame.h"
+
+void spsc_ringbuffer_init(spsc_rbctx_t *context, void *buffer_location, size_t buffer_size)
+{
+    context->begin = buffer_location;
+    context->size = buffer_size;
+    context->read_cache = 0;
+    context->write_cache = 0;
+    atomic_init(&context->write, 0);
+    atomic_init(&context->read, 0);
+}
+
+int spsc_ringbuffer_write(spsc_rbctx_t *context, void *message, size_t message_len)
+{
+    size_t needed = sizeof(size_t) + message_len;
+    size_t write = atomic_load_explicit(&context->write, memory_order_relaxed);
+
+    //only look at the consumer's index if the cached one says we are full
+    if (rb_frame_space(context->size, context->read_cache, write) < needed) {
+        context->read_cache = atomic_load_explicit(&context->read, memory_order_acquire);
+        if (rb_frame_space(context->size, context->read_cache, write) < needed) {
+            return RINGBUFFER_FULL;
+        }
+    }
+
+    write = rb_frame_put(context->begin, context->size, write, &message_len, sizeof(size_t));
+    write = rb_frame_put(context->begin, context->size, write, message, message_len);
+
+    //publish the message
+    atomic_store_explicit(&context->write, write, memory_order_release);
+    return SUCCESS;
+}
+
+int spsc_ringbuffer_read(spsc_rbctx_t *context, void *buffer, size_t *buffer_len)
+{
+    size_t read = atomic_load_explicit(&context->read, memory_order_relaxed);
+
+    //only look at the producer's index if the cached one says we are empty
+    if (read == context->write_cache) {
+        context->write_cache = atomic_load_explicit(&context->write, memory_order_acquire);
+        if (read == context->write_cache) {
+            return RINGBUFFER_EMPTY;
+        }
+    }
+
+    size_t message_len;
+    size_t payload = rb_frame_get(context->begin, context->size, read, &message_len, sizeof(size_t));
+    if (message_len > *buffer_len) {
+        *buffer_len = message_len;
+        return OUTPUT_BUFFER_TOO_SMALL;
+    }
+
+    read = rb_frame_get(context->begin, context->size, payload, buffer, message_len);
+    *buffer_len = message_len;
+
+    //hand the space back to the producer
+    atomic_store_explicit(&context->read, read, memory_order_release);
+    return SUCCESS;
+}
+
+void spsc_ringbuffer_destroy(spsc_rbctx_t *context)
+{
+    context->begin = NULL;
+    context->size = 0;
+}
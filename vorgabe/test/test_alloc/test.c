@@ -0,0 +1,102 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+
+//one message round trip through a created ringbuffer
+static int round_trip(rbctx_t *ringbuffer_context)
+{
+    char buffer[32];
+    size_t len = sizeof(buffer);
+    if (ringbuffer_write(ringbuffer_context, "created", 8) != SUCCESS) {
+        return 0;
+    }
+    return ringbuffer_read(ringbuffer_context, buffer, &len) == SUCCESS && len == 8 && strcmp(buffer, "created") == 0;
+}
+
+int main()
+{
+    rbctx_t *ringbuffer_context;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Aligned memory on normal pages, with and without prefaulting          *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: ringbuffer_create\n");
+
+    if (ringbuffer_create(0, RBUF_VARINT, RBUF_NUMA_ANY) != NULL) {
+        printf("Error: Test 1.1 failed. Expected NULL for size 0\n");
+        exit(1);
+    }
+    if (ringbuffer_create(1000, RBUF_POW2, RBUF_NUMA_ANY) != NULL) {
+        printf("Error: Test 1.2 failed. Expected NULL for RBUF_POW2 and size 1000\n");
+        exit(1);
+    }
+
+    int flags[2] = {RBUF_VARINT, RBUF_VARINT | RBUF_POW2 | RBUF_PREFAULT};
+    for (int i = 0; i < 2; i++) {
+        ringbuffer_context = ringbuffer_create(1 << 16, flags[i], RBUF_NUMA_ANY);
+        if (ringbuffer_context == NULL) {
+            printf("Error: Test 1.3 failed. Expected a ringbuffer for flags %#x\n", flags[i]);
+            exit(1);
+        }
+        if ((uintptr_t) ringbuffer_context->begin % RBUF_CACHELINE != 0 || (uintptr_t) ringbuffer_context % RBUF_CACHELINE != 0) {
+            printf("Error: Test 1.4 failed. Expected context and memory on a cache line boundary\n");
+            exit(1);
+        }
+        if (ringbuffer_context->end - ringbuffer_context->begin != 1 << 16) {
+            printf("Error: Test 1.5 failed. Expected a ringbuffer of 65536 bytes\n");
+            exit(1);
+        }
+        if (!round_trip(ringbuffer_context)) {
+            printf("Error: Test 1.6 failed. Expected the message back\n");
+            exit(1);
+        }
+        ringbuffer_free(ringbuffer_context);
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Huge pages and NUMA binding                                           *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: huge pages and NUMA binding\n");
+
+    /* without reserved huge pages it falls back to transparent ones */
+    ringbuffer_context = ringbuffer_create(3 << 20, RBUF_VARINT | RBUF_HUGEPAGES | RBUF_PREFAULT, RBUF_NUMA_ANY);
+    if (ringbuffer_context == NULL || (uintptr_t) ringbuffer_context->begin % (2 << 20) != 0) {
+        printf("Error: Test 2.1 failed. Expected a ringbuffer on a huge page boundary\n");
+        exit(1);
+    }
+    if (ringbuffer_context->mapped_len != 4 << 20 || !round_trip(ringbuffer_context)) {
+        printf("Error: Test 2.2 failed. Expected 4 MiB mapped and the message back\n");
+        exit(1);
+    }
+    ringbuffer_free(ringbuffer_context);
+
+    int nodes[3] = {4096, -2, (int) (sizeof(unsigned long) * CHAR_BIT)};
+    for (int i = 0; i < 3; i++) {
+        errno = 0;
+        if (ringbuffer_create(4096, RBUF_VARINT, nodes[i]) != NULL || errno != EINVAL) {
+            printf("Error: Test 2.3 failed. Expected NULL and EINVAL for NUMA node %d\n", nodes[i]);
+            exit(1);
+        }
+    }
+    /* node 0 exists wherever the kernel has NUMA support */
+    ringbuffer_context = ringbuffer_create(4096, RBUF_VARINT | RBUF_PREFAULT, 0);
+    if (ringbuffer_context != NULL) {
+        if (!round_trip(ringbuffer_context)) {
+            printf("Error: Test 2.4 failed. Expected the message back\n");
+            exit(1);
+        }
+        ringbuffer_free(ringbuffer_context);
+    } else {
+        printf("  NUMA binding not supported, skipped\n");
+    }
+    printf("  + Test 2 passed\n");
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 80;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    ringbuffer_init(ringbuffer_context, rbuf, rbuf_size);
+
+    char *msg[4] = {"first", "second message", "third", "this one does not fit anymore"};
+    struct iovec messages[4];
+    for (int i = 0; i < 4; i++) {
+        messages[i].iov_base = msg[i];
+        messages[i].iov_len = strlen(msg[i]) + 1;
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Batch write stops at the first message that doesn't fit               *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: batch write\n");
+
+    size_t nr_written;
+    if (ringbuffer_write_batch(ringbuffer_context, messages, 4, &nr_written) != SUCCESS || nr_written != 3) {
+        printf("Error: Test 1 failed. Expected 3 messages written\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Batch read honours the message limit, buffer size and empty ring      *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: batch read\n");
+
+    char buffer[100];
+    size_t offsets[5];
+    size_t nr_read;
+
+    if (ringbuffer_read_batch(ringbuffer_context, buffer, 3, offsets, 4, &nr_read) != OUTPUT_BUFFER_TOO_SMALL || nr_read != 0) {
+        printf("Error: Test 2.1 failed. Expected OUTPUT_BUFFER_TOO_SMALL\n");
+        exit(1);
+    }
+
+    if (ringbuffer_read_batch(ringbuffer_context, buffer, sizeof(buffer), offsets, 1, &nr_read) != SUCCESS || nr_read != 1 ||
+        strcmp(buffer + offsets[0], msg[0]) != 0 || offsets[1] != messages[0].iov_len) {
+        printf("Error: Test 2.2 failed. Expected only the first message\n");
+        exit(1);
+    }
+
+    /* only room for the second message */
+    if (ringbuffer_read_batch(ringbuffer_context, buffer, messages[1].iov_len + 2, offsets, 4, &nr_read) != SUCCESS || nr_read != 1 ||
+        strcmp(buffer, msg[1]) != 0) {
+        printf("Error: Test 2.3 failed. Expected only the second message\n");
+        exit(1);
+    }
+
+    if (ringbuffer_write_batch(ringbuffer_context, &messages[3], 1, &nr_written) != SUCCESS || nr_written != 1) {
+        printf("Error: Test 2.4 failed. Expected the fourth message to fit now\n");
+        exit(1);
+    }
+    if (ringbuffer_read_batch(ringbuffer_context, buffer, sizeof(buffer), offsets, 4, &nr_read) != SUCCESS || nr_read != 2 ||
+        strcmp(buffer + offsets[0], msg[2]) != 0 || strcmp(buffer + offsets[1], msg[3]) != 0 ||
+        offsets[2] != messages[2].iov_len + messages[3].iov_len) {
+        printf("Error: Test 2.4 failed. Expected the third and fourth message\n");
+        exit(1);
+    }
+
+    if (ringbuffer_read_batch(ringbuffer_context, buffer, sizeof(buffer), offsets, 4, &nr_read) != RINGBUFFER_EMPTY || nr_read != 0) {
+        printf("Error: Test 2.5 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
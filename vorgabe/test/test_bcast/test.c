@@ -0,0 +1,155 @@
+#include "../include/ringbuf_bcast.h"
+#include <stdio.h>
+
+#define NR_MESSAGES 10000
+
+static bcast_rbctx_t ringbuffer_context;
+
+static void* subscriber(void* arg)
+{
+    size_t id = (size_t) arg;
+    for (int i = 0; i < NR_MESSAGES; i++) {
+        int msg;
+        size_t len = sizeof(msg);
+        if (bcast_ringbuffer_read(&ringbuffer_context, id, &msg, &len) != SUCCESS || msg != i) {
+            printf("Error: Test 3 failed. Subscriber %zu expected message %d\n", id, i);
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+int main()
+{
+    size_t rbuf_size = 64;
+    char *rbuf = malloc(rbuf_size);
+    if (rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    char buffer[64];
+    size_t len;
+    uint64_t behind, lost;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Every subscriber sees every message, the slowest one gates the writer *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: gated\n");
+
+    if (bcast_ringbuffer_init(&ringbuffer_context, rbuf, rbuf_size, RBUF_VARINT, 0, RBUF_BCAST_GATED) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID without subscribers\n");
+        exit(1);
+    }
+    if (bcast_ringbuffer_init(&ringbuffer_context, rbuf, rbuf_size, RBUF_EVENTFD, 2, RBUF_BCAST_GATED) != RINGBUFFER_INVALID
+        || bcast_ringbuffer_init(&ringbuffer_context, rbuf, rbuf_size, RBUF_TIMESTAMPS, 2, RBUF_BCAST_GATED) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for RBUF_EVENTFD and RBUF_TIMESTAMPS\n");
+        exit(1);
+    }
+    bcast_ringbuffer_init(&ringbuffer_context, rbuf, rbuf_size, RBUF_VARINT, 2, RBUF_BCAST_GATED);
+
+    /* 8 messages of 7 + 1 bytes use the whole memory */
+    for (int i = 0; i < 8; i++) {
+        if (bcast_ringbuffer_write(&ringbuffer_context, "abcdef", 7) != SUCCESS) {
+            printf("Error: Test 1.2 failed. Expected message %d to fit\n", i);
+            exit(1);
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        len = sizeof(buffer);
+        if (bcast_ringbuffer_read(&ringbuffer_context, 0, buffer, &len) != SUCCESS || strcmp(buffer, "abcdef") != 0) {
+            printf("Error: Test 1.3 failed. Subscriber 0 expected message %d\n", i);
+            exit(1);
+        }
+    }
+    if (bcast_ringbuffer_write(&ringbuffer_context, "abcdef", 7) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.4 failed. Expected subscriber 1 to gate the writer\n");
+        exit(1);
+    }
+    bcast_ringbuffer_lag(&ringbuffer_context, 1, &behind, &lost);
+    if (behind != 64 || lost != 0) {
+        printf("Error: Test 1.5 failed. Expected subscriber 1 to be 64 bytes behind\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (bcast_ringbuffer_read(&ringbuffer_context, 1, buffer, &len) != SUCCESS ||
+        bcast_ringbuffer_write(&ringbuffer_context, "ghijkl", 7) != SUCCESS) {
+        printf("Error: Test 1.6 failed. Expected room after subscriber 1 read\n");
+        exit(1);
+    }
+    bcast_ringbuffer_destroy(&ringbuffer_context);
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Overwrite mode drops the oldest messages of a lagging subscriber      *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: overwrite\n");
+
+    bcast_ringbuffer_init(&ringbuffer_context, rbuf, rbuf_size, RBUF_VARINT, 2, RBUF_BCAST_OVERWRITE);
+    for (int i = 0; i < 20; i++) {
+        if (bcast_ringbuffer_write(&ringbuffer_context, &i, sizeof(i)) != SUCCESS) {
+            printf("Error: Test 2.1 failed. Expected SUCCESS\n");
+            exit(1);
+        }
+        int msg;
+        len = sizeof(msg);
+        if (bcast_ringbuffer_read(&ringbuffer_context, 0, &msg, &len) != SUCCESS || msg != i) {
+            printf("Error: Test 2.2 failed. Subscriber 0 expected message %d\n", i);
+            exit(1);
+        }
+    }
+
+    /* 64 bytes hold the last 12 messages of 4 + 1 bytes */
+    bcast_ringbuffer_lag(&ringbuffer_context, 1, &behind, &lost);
+    if (lost != 8 || behind != 60) {
+        printf("Error: Test 2.3 failed. Expected subscriber 1 to have lost 8 messages\n");
+        exit(1);
+    }
+    for (int i = 8; i < 20; i++) {
+        int msg;
+        len = sizeof(msg);
+        if (bcast_ringbuffer_read(&ringbuffer_context, 1, &msg, &len) != SUCCESS || msg != i) {
+            printf("Error: Test 2.4 failed. Subscriber 1 expected message %d\n", i);
+            exit(1);
+        }
+    }
+    bcast_ringbuffer_destroy(&ringbuffer_context);
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Subscriber threads each get the whole stream in order                 *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: threaded\n");
+
+    bcast_ringbuffer_init(&ringbuffer_context, rbuf, rbuf_size, 0, 3, RBUF_BCAST_GATED);
+    pthread_t subscribers[3];
+    for (size_t i = 0; i < 3; i++) {
+        pthread_create(&subscribers[i], NULL, subscriber, (void*) i);
+    }
+    for (int i = 0; i < NR_MESSAGES; i++) {
+        if (bcast_ringbuffer_write(&ringbuffer_context, &i, sizeof(i)) != SUCCESS) {
+            printf("Error: Test 3 failed. Write %d failed\n", i);
+            exit(1);
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        pthread_join(subscribers[i], NULL);
+    }
+    bcast_ringbuffer_destroy(&ringbuffer_context);
+
+    printf("  + Test 3 passed\n");
+
+    free(rbuf);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#define NUMBER_OF_MESSAGES 20000
+#define NUMBER_OF_WRITERS 2
+#define RBUF_SIZE 64  // bytes, writers are parked on a full ringbuffer most of the time
+
+rbctx_t ringbuffer_context;
+
+void *writer(void *arg)
+{
+    size_t first = (size_t) arg;
+    for (size_t i = first; i < NUMBER_OF_MESSAGES; i += NUMBER_OF_WRITERS) {
+        if (ringbuffer_write_blocking(&ringbuffer_context, &i, sizeof(i)) != SUCCESS) {
+            printf("Error: blocking write failed\n");
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+int main()
+{
+    char *rbuf = malloc(RBUF_SIZE);
+    if (rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    ringbuffer_init(&ringbuffer_context, rbuf, RBUF_SIZE);
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Blocking calls return immediately when they can never succeed         *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: oversized message and too small buffer\n");
+
+    char big[RBUF_SIZE];
+    if (ringbuffer_write_blocking(&ringbuffer_context, big, RBUF_SIZE - sizeof(size_t)) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID\n");
+        exit(1);
+    }
+
+    size_t value = 42;
+    ringbuffer_write_blocking(&ringbuffer_context, &value, sizeof(value));
+    size_t len = sizeof(value) - 1;
+    if (ringbuffer_read_blocking(&ringbuffer_context, &value, &len) != OUTPUT_BUFFER_TOO_SMALL || len != sizeof(value)) {
+        printf("Error: Test 1.2 failed. Expected OUTPUT_BUFFER_TOO_SMALL with required size\n");
+        exit(1);
+    }
+    value = 0;
+    if (ringbuffer_read_blocking(&ringbuffer_context, &value, &len) != SUCCESS || value != 42) {
+        printf("Error: Test 1.2 failed. Expected to read the message after retry\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Writers and a reader parked on a full/empty ringbuffer make progress  *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: blocking writers and reader\n");
+
+    pthread_t w[NUMBER_OF_WRITERS];
+    for (size_t i = 0; i < NUMBER_OF_WRITERS; i++) {
+        pthread_create(&w[i], NULL, writer, (void *) i);
+    }
+
+    size_t sum = 0;
+    for (size_t i = 0; i < NUMBER_OF_MESSAGES; i++) {
+        len = sizeof(value);
+        if (ringbuffer_read_blocking(&ringbuffer_context, &value, &len) != SUCCESS || value >= NUMBER_OF_MESSAGES) {
+            printf("Error: Test 2 failed. Incorrect message read\n");
+            exit(1);
+        }
+        sum += value;
+    }
+    for (size_t i = 0; i < NUMBER_OF_WRITERS; i++) {
+        pthread_join(w[i], NULL);
+    }
+
+    if (sum != (size_t) NUMBER_OF_MESSAGES * (NUMBER_OF_MESSAGES - 1) / 2) {
+        printf("Error: Test 2 failed. Messages lost or duplicated\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    ringbuffer_destroy(&ringbuffer_context);
+    free(rbuf);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
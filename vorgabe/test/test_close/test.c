@@ -0,0 +1,192 @@
+#include "../include/ringbuf.h"
+#include "../include/ringbuf_group.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#define RBUF_SIZE 64
+#define NUMBER_OF_READERS 2
+
+rbctx_t ringbuffer_context;
+
+void *reader(void *arg)
+{
+    char buf[RBUF_SIZE];
+    size_t len = sizeof(buf);
+    *(int *) arg = ringbuffer_read_blocking(&ringbuffer_context, buf, &len);
+    return NULL;
+}
+
+void *writer(void *arg)
+{
+    char message[40] = {0};
+    *(int *) arg = ringbuffer_write_blocking(&ringbuffer_context, message, sizeof(message));
+    return NULL;
+}
+
+int main()
+{
+    char rbuf[RBUF_SIZE];
+    char buf[RBUF_SIZE];
+    size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Readers blocked on an empty ringbuffer wake up with RINGBUFFER_CLOSED *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: close wakes blocked readers\n");
+
+    ringbuffer_init(&ringbuffer_context, rbuf, RBUF_SIZE);
+    pthread_t threads[NUMBER_OF_READERS];
+    int results[NUMBER_OF_READERS];
+    for (int i = 0; i < NUMBER_OF_READERS; i++) {
+        pthread_create(&threads[i], NULL, reader, &results[i]);
+    }
+    usleep(50000);
+    ringbuffer_close(&ringbuffer_context);
+    for (int i = 0; i < NUMBER_OF_READERS; i++) {
+        pthread_join(threads[i], NULL);
+        if (results[i] != RINGBUFFER_CLOSED) {
+            printf("Error: Test 1 failed. Expected RINGBUFFER_CLOSED, got %d\n", results[i]);
+            exit(1);
+        }
+    }
+    ringbuffer_destroy(&ringbuffer_context);
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * A writer blocked on a full ringbuffer wakes up with RINGBUFFER_CLOSED *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: close wakes blocked writers\n");
+
+    ringbuffer_init(&ringbuffer_context, rbuf, RBUF_SIZE);
+    ringbuffer_write(&ringbuffer_context, buf, 40);
+    int result;
+    pthread_create(&threads[0], NULL, writer, &result);
+    usleep(50000);
+    ringbuffer_close(&ringbuffer_context);
+    pthread_join(threads[0], NULL);
+    if (result != RINGBUFFER_CLOSED) {
+        printf("Error: Test 2 failed. Expected RINGBUFFER_CLOSED, got %d\n", result);
+        exit(1);
+    }
+    ringbuffer_destroy(&ringbuffer_context);
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Writes fail after close, reads drain the messages first               *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: drain after close\n");
+
+    ringbuffer_init(&ringbuffer_context, rbuf, RBUF_SIZE);
+    ringbuffer_write(&ringbuffer_context, "first", 6);
+    ringbuffer_write(&ringbuffer_context, "second", 7);
+    ringbuffer_close(&ringbuffer_context);
+    if (ringbuffer_write(&ringbuffer_context, "third", 6) != RINGBUFFER_CLOSED
+        || ringbuffer_try_write(&ringbuffer_context, "third", 6) != RINGBUFFER_CLOSED) {
+        printf("Error: Test 3.1 failed. Expected RINGBUFFER_CLOSED for a write\n");
+        exit(1);
+    }
+    const char *expected[2] = {"first", "second"};
+    for (int i = 0; i < 2; i++) {
+        len = sizeof(buf);
+        if (ringbuffer_read(&ringbuffer_context, buf, &len) != SUCCESS || strcmp(buf, expected[i]) != 0) {
+            printf("Error: Test 3.2 failed. Expected to read %s\n", expected[i]);
+            exit(1);
+        }
+    }
+    len = sizeof(buf);
+    if (ringbuffer_try_read(&ringbuffer_context, buf, &len) != RINGBUFFER_CLOSED
+        || ringbuffer_peek_len(&ringbuffer_context, &len) != RINGBUFFER_CLOSED) {
+        printf("Error: Test 3.3 failed. Expected RINGBUFFER_CLOSED once drained\n");
+        exit(1);
+    }
+    ringbuffer_destroy(&ringbuffer_context);
+    printf("  + Test 3 passed\n");
+
+    /*************************************************************************
+     * TEST 4:                                                               *
+     * Poll loops and groups see the close                                   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 4: poll and group\n");
+
+    ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_EVENTFD);
+    rbctx_t *contexts[1] = {&ringbuffer_context};
+    size_t ready;
+    ringbuffer_close(&ringbuffer_context);
+    if (ringbuffer_poll(contexts, 1, &ready, RBUF_NO_WAIT) != SUCCESS) {
+        printf("Error: Test 4.1 failed. Expected read_fd to be readable after close\n");
+        exit(1);
+    }
+    ringbuffer_destroy(&ringbuffer_context);
+
+    rbgroup_t group;
+    ringbuffer_group_init(&group, 2, RBUF_SIZE, 0, RBUF_GROUP_ROUND_ROBIN);
+    ringbuffer_write(ringbuffer_group_lane(&group, 1), "lane", 5);
+    ringbuffer_group_close(&group);
+    len = sizeof(buf);
+    if (ringbuffer_group_read(&group, buf, &len) != SUCCESS || strcmp(buf, "lane") != 0) {
+        printf("Error: Test 4.2 failed. Expected to read the message of lane 1\n");
+        exit(1);
+    }
+    uint64_t start_ns = ringbuffer_now_ns();
+    len = sizeof(buf);
+    if (ringbuffer_group_read(&group, buf, &len) != RINGBUFFER_CLOSED
+        || ringbuffer_now_ns() - start_ns > 100000000) {
+        printf("Error: Test 4.3 failed. Expected RINGBUFFER_CLOSED right away\n");
+        exit(1);
+    }
+    ringbuffer_group_destroy(&group);
+    printf("  + Test 4 passed\n");
+
+    /*************************************************************************
+     * TEST 5:                                                               *
+     * An open reservation keeps readers waiting for its commit or abort     *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 5: reservation open at close\n");
+
+    struct iovec vec[2];
+    ringbuffer_init(&ringbuffer_context, rbuf, RBUF_SIZE);
+    ringbuffer_write_reserve(&ringbuffer_context, 8, vec);
+    ringbuffer_close(&ringbuffer_context);
+    len = sizeof(buf);
+    if (ringbuffer_try_read(&ringbuffer_context, buf, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 5.1 failed. Expected RINGBUFFER_EMPTY while the reservation is open\n");
+        exit(1);
+    }
+    pthread_create(&threads[0], NULL, reader, &result);
+    usleep(50000);
+    memcpy(vec[0].iov_base, "late", 5);
+    ringbuffer_write_commit(&ringbuffer_context, 5);
+    pthread_join(threads[0], NULL);
+    if (result != SUCCESS) {
+        printf("Error: Test 5.2 failed. Expected the blocked reader to get the committed message, got %d\n", result);
+        exit(1);
+    }
+    ringbuffer_destroy(&ringbuffer_context);
+
+    ringbuffer_init(&ringbuffer_context, rbuf, RBUF_SIZE);
+    ringbuffer_write_reserve(&ringbuffer_context, 8, vec);
+    ringbuffer_close(&ringbuffer_context);
+    pthread_create(&threads[0], NULL, reader, &result);
+    usleep(50000);
+    ringbuffer_write_abort(&ringbuffer_context);
+    pthread_join(threads[0], NULL);
+    if (result != RINGBUFFER_CLOSED) {
+        printf("Error: Test 5.3 failed. Expected RINGBUFFER_CLOSED after the abort, got %d\n", result);
+        exit(1);
+    }
+    ringbuffer_destroy(&ringbuffer_context);
+    printf("  + Test 5 passed\n");
+
+    printf("All tests passed\n");
+    return 0;
+}
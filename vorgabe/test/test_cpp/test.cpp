@@ -0,0 +1,135 @@
+#include "../include/ringbuf.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+struct Point {
+    int x;
+    int y;
+};
+
+//trivially copyable without a default constructor
+struct Id {
+    explicit Id(int value) : value(value) {}
+    int value;
+};
+
+static std::span<const std::byte> bytes(const char *text)
+{
+    return std::as_bytes(std::span<const char>(text, std::strlen(text) + 1));
+}
+
+int main()
+{
+    std::byte buffer[64];
+    std::size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * ByteRing writes and reads messages, native() works from C             *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: ByteRing\n");
+
+    ringbuf::ByteRing<64, 16> ring;
+    static_assert(ring.pow2 && (ring.flags & RBUF_POW2), "64 bytes select RBUF_POW2");
+    if (ring.write(bytes("first")) != SUCCESS || ring.try_write(bytes("second")) != SUCCESS) {
+        printf("Error: Test 1.1 failed. Expected SUCCESS for both writes\n");
+        exit(1);
+    }
+    if (ring.try_write(bytes("more than 16 bytes")) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.2 failed. Expected RINGBUFFER_INVALID above MaxMsg\n");
+        exit(1);
+    }
+    if (ring.read(std::span(buffer, 3), len) != OUTPUT_BUFFER_TOO_SMALL || len != 6) {
+        printf("Error: Test 1.3 failed. Expected OUTPUT_BUFFER_TOO_SMALL with length 6\n");
+        exit(1);
+    }
+    if (ring.read(buffer, len) != SUCCESS || len != 6 || std::strcmp((char *) buffer, "first") != 0) {
+        printf("Error: Test 1.4 failed. Expected to read 'first'\n");
+        exit(1);
+    }
+    char text[16];
+    len = sizeof(text);
+    if (ringbuffer_read(ring.native(), text, &len) != SUCCESS || std::strcmp(text, "second") != 0) {
+        printf("Error: Test 1.5 failed. Expected the C side to read 'second'\n");
+        exit(1);
+    }
+    if (ring.try_read(buffer, len) != RINGBUFFER_EMPTY || ring.used() != 0) {
+        printf("Error: Test 1.6 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Ringbuffer of values, moving keeps the messages                       *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: Ringbuffer of values\n");
+
+    ringbuf::Ringbuffer<Point, 4> points;
+    if (points.capacity < 4) {
+        printf("Error: Test 2.1 failed. Expected room for 4 points, got %zu\n", points.capacity);
+        exit(1);
+    }
+    for (int i = 0; i < 4; i++) {
+        if (points.push(Point{i, -i}) != SUCCESS) {
+            printf("Error: Test 2.2 failed. Expected to push point %d\n", i);
+            exit(1);
+        }
+    }
+    ringbuf::Ringbuffer<Point, 4> moved = std::move(points);
+    if (moved.size() != 4) {
+        printf("Error: Test 2.3 failed. Expected 4 points after the move, got %zu\n", moved.size());
+        exit(1);
+    }
+    for (int i = 0; i < 4; i++) {
+        std::optional<Point> point = moved.pop();
+        if (!point || point->x != i || point->y != -i) {
+            printf("Error: Test 2.4 failed. Expected point %d\n", i);
+            exit(1);
+        }
+    }
+    if (ringbuffer_try_read(moved.native(), text, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.5 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    ringbuf::Ringbuffer<Id, 2> ids;
+    if (ids.push(Id(7)) != SUCCESS || ids.pop().value_or(Id(0)).value != 7 || ids.pop()) {
+        printf("Error: Test 2.6 failed. Expected Id 7 and then nothing\n");
+        exit(1);
+    }
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Flags ringbuffer_init_flags rejects throw std::invalid_argument       *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: invalid flags\n");
+
+    try {
+        ringbuf::ByteRing<64> both(RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF);
+        printf("Error: Test 3.1 failed. Expected std::invalid_argument for both wait strategies\n");
+        exit(1);
+    } catch (const std::invalid_argument &) {
+    }
+    try {
+        ringbuf::ByteRing<48> odd(RBUF_POW2);
+        printf("Error: Test 3.2 failed. Expected std::invalid_argument for RBUF_POW2 with 48 bytes\n");
+        exit(1);
+    } catch (const std::invalid_argument &) {
+    }
+    ringbuf::ByteRing<48> timed(RBUF_TIMESTAMPS | RBUF_WAIT_BACKOFF);
+    if (timed.try_write(bytes("timed")) != SUCCESS || timed.try_read(buffer, len) != SUCCESS || len != 6) {
+        printf("Error: Test 3.3 failed. Expected valid flags to work\n");
+        exit(1);
+    }
+    printf("  + Test 3 passed\n");
+
+    printf("All tests passed\n");
+    return 0;
+}
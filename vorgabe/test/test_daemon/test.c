@@ -26,9 +26,26 @@ int check_files(const char *file1, const char *file2) {
             return 1;
         }
     }
+    /* a packet written twice would leave more behind */
+    c2 = fgetc(fp2);
 
     fclose(fp1);
     fclose(fp2);
+    return c2 != EOF;
+}
+
+/* all packets of every connection arrived once and in order: each port
+ * file is exactly the filtered input of its one writer */
+int check_results(void) {
+    const char *expected[3] = {"test/test_daemon/rndtxt1_lsg.txt", "test/test_daemon/rndtxt2_lsg.txt",
+                               "test/test_daemon/rndtxt3_lsg.txt"};
+    const char *written[3] = {"11.txt", "12.txt", "13.txt"};
+    for (int i = 0; i < 3; i++) {
+        if (check_files(expected[i], written[i]) != 0) {
+            fprintf(stderr, "Error: files %s and %s are not the same\n", written[i], expected[i]);
+            return 1;
+        }
+    }
     return 0;
 }
 
@@ -92,6 +109,47 @@ int main() {
         return 1;
     }
 
+    /* every ring implementation and option, small rings so writers have to wait, spill or grow */
+    struct {
+        const char *name;
+        daemon_options_t options;
+    } modes[] = {
+        {"spill", {.ring = DAEMON_RING_LOCKED, .ring_size = 256, .number_of_processing_threads = 4,
+                   .spill_dir = "/tmp", .spill_size = 4096}},
+        {"mpmc", {.ring = DAEMON_RING_MPMC, .ring_size = 512, .number_of_processing_threads = 4}},
+        {"group", {.ring = DAEMON_RING_GROUP, .ring_size = 256, .number_of_processing_threads = 4}},
+        {"group of 2 lanes", {.ring = DAEMON_RING_GROUP, .ring_size = 256, .number_of_processing_threads = 2,
+                              .number_of_lanes = 2, .measure_latency = 1}},
+        {"shm", {.ring = DAEMON_RING_SHM, .ring_size = 1024, .number_of_processing_threads = 4,
+                 .shm_name = "/simpledaemon_test"}},
+        {"elastic", {.ring = DAEMON_RING_ELASTIC, .ring_size = 256, .ring_size_max = 4096,
+                     .number_of_processing_threads = 4}},
+    };
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        printf("Executing daemon with the %s ring\n", modes[i].name);
+        remove("11.txt");
+        remove("12.txt");
+        remove("13.txt");
+        if (simpledaemon_with_options((connection_t *)connection, 3, &modes[i].options) != 0
+            || check_results() != 0) {
+            fprintf(stderr, "Error: daemon with the %s ring failed\n", modes[i].name);
+            return 1;
+        }
+    }
+
+    /* rejected before any thread starts */
+    daemon_options_t invalid[3] = {
+        {.ring = DAEMON_RING_LOCKED, .ring_size = 0, .number_of_processing_threads = 4},
+        {.ring = DAEMON_RING_LOCKED, .ring_size = 64, .number_of_processing_threads = 4},
+        {.ring = DAEMON_RING_LOCKED, .ring_size = 1024, .number_of_processing_threads = 0},
+    };
+    for (int i = 0; i < 3; i++) {
+        if (simpledaemon_with_options((connection_t *)connection, 3, &invalid[i]) != 1) {
+            fprintf(stderr, "Error: invalid options %d were not rejected\n", i);
+            return 1;
+        }
+    }
+
     printf("Test passed!\n");
 
     return 0;
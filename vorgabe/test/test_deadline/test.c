@@ -0,0 +1,97 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+#define MS 1000000ull  // ns
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 32;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    ringbuffer_init(ringbuffer_context, rbuf, rbuf_size);
+
+    char msg[] = "0123456789";
+    char buffer[32];
+    size_t buffer_len = sizeof(buffer);
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * try variants return right away                                        *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: try read and write\n");
+
+    uint64_t start = ringbuffer_now_ns();
+    if (ringbuffer_try_read(ringbuffer_context, buffer, &buffer_len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    if (ringbuffer_try_write(ringbuffer_context, msg, sizeof(msg)) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    if (ringbuffer_try_write(ringbuffer_context, msg, sizeof(msg)) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.3 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+    buffer_len = 1;
+    if (ringbuffer_try_read(ringbuffer_context, buffer, &buffer_len) != OUTPUT_BUFFER_TOO_SMALL || buffer_len != sizeof(msg)) {
+        printf("Error: Test 1.4 failed. Expected OUTPUT_BUFFER_TOO_SMALL with required size\n");
+        exit(1);
+    }
+    if (ringbuffer_now_ns() - start > 100 * MS) {
+        printf("Error: Test 1 failed. try calls must not wait\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * until variants wait until the deadline, not for RBUF_TIMEOUT          *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: read and write until a deadline\n");
+
+    start = ringbuffer_now_ns();
+    if (ringbuffer_write_until(ringbuffer_context, msg, sizeof(msg), start + 50 * MS) != RINGBUFFER_FULL) {
+        printf("Error: Test 2.1 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+    uint64_t waited = ringbuffer_now_ns() - start;
+    if (waited < 50 * MS || waited > 500 * MS) {
+        printf("Error: Test 2.1 failed. Waited %llu ms instead of 50 ms\n", (unsigned long long) (waited / MS));
+        exit(1);
+    }
+
+    buffer_len = sizeof(buffer);
+    if (ringbuffer_read_until(ringbuffer_context, buffer, &buffer_len, RBUF_NO_WAIT) != SUCCESS || strcmp(buffer, msg) != 0) {
+        printf("Error: Test 2.2 failed. Expected to read the message\n");
+        exit(1);
+    }
+
+    start = ringbuffer_now_ns();
+    if (ringbuffer_read_until(ringbuffer_context, buffer, &buffer_len, start + 50 * MS) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.3 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    waited = ringbuffer_now_ns() - start;
+    if (waited < 50 * MS || waited > 500 * MS) {
+        printf("Error: Test 2.3 failed. Waited %llu ms instead of 50 ms\n", (unsigned long long) (waited / MS));
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
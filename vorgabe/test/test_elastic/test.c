@@ -0,0 +1,166 @@
+#include "../include/ringbuf_elastic.h"
+#include <stdio.h>
+
+int main()
+{
+    elastic_rbctx_t ringbuffer_context;
+    char buffer[256];
+    char message[16];
+    size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Grows instead of reporting full, messages keep their order            *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: growing\n");
+
+    if (elastic_ringbuffer_init(&ringbuffer_context, 64, 32, RBUF_VARINT) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for max_size below min_size\n");
+        exit(1);
+    }
+    if (elastic_ringbuffer_init(&ringbuffer_context, 64, 100, RBUF_VARINT | RBUF_POW2) != RINGBUFFER_INVALID
+        || elastic_ringbuffer_init(&ringbuffer_context, 32, 256, RBUF_VARINT | RBUF_TIMESTAMPS) != RINGBUFFER_INVALID
+        || elastic_ringbuffer_init(&ringbuffer_context, 32, 256, RBUF_VARINT | RBUF_EVENTFD) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for RBUF_POW2 up to 100 bytes and ring fds or timestamps\n");
+        exit(1);
+    }
+    /* RBUF_POW2 rings double to the next power of two */
+    if (elastic_ringbuffer_init(&ringbuffer_context, 64, 256, RBUF_VARINT | RBUF_POW2 | RBUF_WAIT_BACKOFF) != SUCCESS
+        || elastic_ringbuffer_write(&ringbuffer_context, buffer, 70) != SUCCESS
+        || elastic_ringbuffer_size(&ringbuffer_context) != 128) {
+        printf("Error: Test 1.1 failed. Expected a 70 byte message to grow the RBUF_POW2 ring to 128 bytes\n");
+        exit(1);
+    }
+    elastic_ringbuffer_destroy(&ringbuffer_context);
+    if (elastic_ringbuffer_init(&ringbuffer_context, 32, 256, RBUF_VARINT) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+
+    /* 30 messages of 7 + 1 bytes, a ring of 32 holds 3 */
+    for (int i = 0; i < 30; i++) {
+        snprintf(message, sizeof(message), "msg %02d", i);
+        if (elastic_ringbuffer_write(&ringbuffer_context, message, 7) != SUCCESS) {
+            printf("Error: Test 1.3 failed. Expected write %d to grow the ring\n", i);
+            exit(1);
+        }
+    }
+    if (elastic_ringbuffer_size(&ringbuffer_context) != 256) {
+        printf("Error: Test 1.4 failed. Expected size 256, got %zu\n", elastic_ringbuffer_size(&ringbuffer_context));
+        exit(1);
+    }
+    if (elastic_ringbuffer_write(&ringbuffer_context, buffer, 254) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.5 failed. Expected RINGBUFFER_INVALID above max_size\n");
+        exit(1);
+    }
+    /* the 256 ring holds 31 messages, 5 of them are in it */
+    int written = 30;
+    for (int i = 30; i < 60; i++) {
+        snprintf(message, sizeof(message), "msg %02d", i);
+        if (elastic_ringbuffer_write(&ringbuffer_context, message, 7) != SUCCESS) {
+            break;
+        }
+        written++;
+    }
+    if (written != 56) {
+        printf("Error: Test 1.6 failed. Expected RINGBUFFER_FULL at max_size after 56 messages, got %d\n", written);
+        exit(1);
+    }
+    for (int i = 0; i < written; i++) {
+        snprintf(message, sizeof(message), "msg %02d", i);
+        len = sizeof(buffer);
+        if (elastic_ringbuffer_read(&ringbuffer_context, buffer, &len) != SUCCESS || len != 7 || strcmp(buffer, message) != 0) {
+            printf("Error: Test 1.7 failed. Expected '%s'\n", message);
+            exit(1);
+        }
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Shrinks back when it runs empty with little use                       *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: shrinking\n");
+
+    /* the 256 ring was filled, emptying it doesn't shrink it */
+    if (elastic_ringbuffer_size(&ringbuffer_context) != 256) {
+        printf("Error: Test 2.1 failed. Expected size 256, got %zu\n", elastic_ringbuffer_size(&ringbuffer_context));
+        exit(1);
+    }
+    /* each message below a quarter of the ring halves it once emptied */
+    size_t expected[4] = {128, 64, 32, 32};
+    for (int i = 0; i < 4; i++) {
+        elastic_ringbuffer_write(&ringbuffer_context, "idle", 5);
+        len = sizeof(buffer);
+        if (elastic_ringbuffer_read(&ringbuffer_context, buffer, &len) != SUCCESS || strcmp(buffer, "idle") != 0) {
+            printf("Error: Test 2.2 failed. Expected 'idle'\n");
+            exit(1);
+        }
+        size_t size = elastic_ringbuffer_size(&ringbuffer_context);
+        if (size != expected[i]) {
+            printf("Error: Test 2.3 failed. Expected size %zu, got %zu\n", expected[i], size);
+            exit(1);
+        }
+    }
+    len = sizeof(buffer);
+    if (elastic_ringbuffer_read(&ringbuffer_context, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.4 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * A too small buffer leaves the message in the old ring                 *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: too small buffer while draining\n");
+
+    for (int i = 0; i < 6; i++) {
+        snprintf(message, sizeof(message), "msg %02d", i);
+        elastic_ringbuffer_write(&ringbuffer_context, message, 7);
+    }
+    len = 3;
+    if (elastic_ringbuffer_read(&ringbuffer_context, buffer, &len) != OUTPUT_BUFFER_TOO_SMALL || len != 7) {
+        printf("Error: Test 3.1 failed. Expected OUTPUT_BUFFER_TOO_SMALL with length 7\n");
+        exit(1);
+    }
+    for (int i = 0; i < 6; i++) {
+        snprintf(message, sizeof(message), "msg %02d", i);
+        len = sizeof(buffer);
+        if (elastic_ringbuffer_read(&ringbuffer_context, buffer, &len) != SUCCESS || strcmp(buffer, message) != 0) {
+            printf("Error: Test 3.2 failed. Expected '%s'\n", message);
+            exit(1);
+        }
+    }
+    printf("  + Test 3 passed\n");
+
+    /*************************************************************************
+     * TEST 4:                                                               *
+     * Counters of all rings, waits included                                 *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 4: stats\n");
+
+    rbstats_t before;
+    rbstats_t after;
+    elastic_ringbuffer_stats(&ringbuffer_context, &before);
+    if (before.messages_in != before.messages_out || before.bytes_in != before.bytes_out || before.full != 1) {
+        printf("Error: Test 4.1 failed. Expected every message read and one RINGBUFFER_FULL\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    elastic_ringbuffer_read(&ringbuffer_context, buffer, &len);
+    elastic_ringbuffer_stats(&ringbuffer_context, &after);
+    if (after.empty != before.empty + 1 || after.timeouts != before.timeouts + 1 || after.wait_ns <= before.wait_ns) {
+        printf("Error: Test 4.2 failed. Expected the empty read to be counted as a timed out wait\n");
+        exit(1);
+    }
+    printf("  + Test 4 passed\n");
+
+    elastic_ringbuffer_destroy(&ringbuffer_context);
+    printf("All tests passed\n");
+    return 0;
+}
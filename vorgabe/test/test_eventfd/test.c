@@ -0,0 +1,155 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define NUMBER_OF_RINGS 3
+#define RBUF_SIZE 32
+
+rbctx_t rings[NUMBER_OF_RINGS];
+
+//readable right now, without waiting
+int fd_readable(int fd)
+{
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1;
+}
+
+void *late_writer(void *arg)
+{
+    (void) arg;
+    usleep(10000);
+    ringbuffer_write(&rings[2], "late", 5);
+    return NULL;
+}
+
+int main()
+{
+    char rbuf[NUMBER_OF_RINGS][RBUF_SIZE];
+    rbctx_t *contexts[NUMBER_OF_RINGS];
+    char buffer[RBUF_SIZE];
+    size_t len;
+    size_t ready;
+
+    for (int i = 0; i < NUMBER_OF_RINGS; i++) {
+        if (ringbuffer_init_flags(&rings[i], rbuf[i], RBUF_SIZE, RBUF_VARINT | RBUF_EVENTFD) != SUCCESS) {
+            printf("Error: ringbuffer_init_flags failed\n");
+            exit(1);
+        }
+        contexts[i] = &rings[i];
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * The fds follow the empty and full transitions                         *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: read and write fd\n");
+
+    if (fd_readable(ringbuffer_read_fd(&rings[0])) || !fd_readable(ringbuffer_write_fd(&rings[0]))) {
+        printf("Error: Test 1.1 failed. Expected only the write fd readable on an empty ringbuffer\n");
+        exit(1);
+    }
+    ringbuffer_write(&rings[0], "one", 4);
+    ringbuffer_write(&rings[0], "two", 4);
+    if (!fd_readable(ringbuffer_read_fd(&rings[0]))) {
+        printf("Error: Test 1.2 failed. Expected the read fd readable after a write\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    ringbuffer_read(&rings[0], buffer, &len);
+    if (!fd_readable(ringbuffer_read_fd(&rings[0]))) {
+        printf("Error: Test 1.3 failed. Expected the read fd readable while a message is left\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    ringbuffer_read(&rings[0], buffer, &len);
+    if (fd_readable(ringbuffer_read_fd(&rings[0]))) {
+        printf("Error: Test 1.4 failed. Expected the read fd cleared on an empty ringbuffer\n");
+        exit(1);
+    }
+
+    /* 31 bytes hold 7 messages of 3 + 1 */
+    while (ringbuffer_try_write(&rings[0], "abc", 3) == SUCCESS) {
+    }
+    if (fd_readable(ringbuffer_write_fd(&rings[0]))) {
+        printf("Error: Test 1.5 failed. Expected the write fd cleared on a full ringbuffer\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    ringbuffer_read(&rings[0], buffer, &len);
+    if (!fd_readable(ringbuffer_write_fd(&rings[0]))) {
+        printf("Error: Test 1.6 failed. Expected the write fd readable after a read\n");
+        exit(1);
+    }
+    while (ringbuffer_try_read(&rings[0], buffer, &len) == SUCCESS) {
+        len = sizeof(buffer);
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * ringbuffer_poll waits on several ringbuffers at once                  *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: ringbuffer_poll\n");
+
+    uint64_t start_ns = ringbuffer_now_ns();
+    if (ringbuffer_poll(contexts, NUMBER_OF_RINGS, &ready, start_ns + 20000000) != RINGBUFFER_EMPTY
+        || ringbuffer_now_ns() - start_ns < 20000000) {
+        printf("Error: Test 2.1 failed. Expected RINGBUFFER_EMPTY after 20 ms\n");
+        exit(1);
+    }
+    ringbuffer_write(&rings[1], "ring 1", 7);
+    if (ringbuffer_poll(contexts, NUMBER_OF_RINGS, &ready, RBUF_NO_WAIT) != SUCCESS || ready != 1) {
+        printf("Error: Test 2.2 failed. Expected ring 1 to be ready\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    ringbuffer_try_read(&rings[1], buffer, &len);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, late_writer, NULL);
+    if (ringbuffer_poll(contexts, NUMBER_OF_RINGS, &ready, RBUF_WAIT_FOREVER) != SUCCESS || ready != 2) {
+        printf("Error: Test 2.3 failed. Expected ring 2 to be ready\n");
+        exit(1);
+    }
+    pthread_join(thread, NULL);
+    len = sizeof(buffer);
+    if (ringbuffer_try_read(&rings[2], buffer, &len) != SUCCESS || strcmp(buffer, "late") != 0) {
+        printf("Error: Test 2.4 failed. Expected 'late'\n");
+        exit(1);
+    }
+
+    rbctx_t plain;
+    rbctx_t *without[1] = {&plain};
+    ringbuffer_init(&plain, buffer, sizeof(buffer));
+    if (ringbuffer_read_fd(&plain) != -1 || ringbuffer_poll(without, 1, &ready, RBUF_NO_WAIT) != RINGBUFFER_INVALID) {
+        printf("Error: Test 2.5 failed. Expected RINGBUFFER_INVALID without RBUF_EVENTFD\n");
+        exit(1);
+    }
+    ringbuffer_destroy(&plain);
+    if (ringbuffer_poll(contexts, 0, &ready, RBUF_NO_WAIT) != RINGBUFFER_INVALID) {
+        printf("Error: Test 2.6 failed. Expected RINGBUFFER_INVALID without contexts\n");
+        exit(1);
+    }
+
+    //30 days are more ms than an int holds
+    pthread_create(&thread, NULL, late_writer, NULL);
+    if (ringbuffer_poll(contexts, NUMBER_OF_RINGS, &ready, ringbuffer_now_ns() + 30 * 86400000000000ull) != SUCCESS
+        || ready != 2) {
+        printf("Error: Test 2.7 failed. Expected ring 2 to be ready before a far deadline\n");
+        exit(1);
+    }
+    pthread_join(thread, NULL);
+    len = sizeof(buffer);
+    ringbuffer_try_read(&rings[2], buffer, &len);
+    printf("  + Test 2 passed\n");
+
+    for (int i = 0; i < NUMBER_OF_RINGS; i++) {
+        ringbuffer_destroy(&rings[i]);
+    }
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "../include/ringbuf_group.h"
+#include <stdio.h>
+#include <unistd.h>
+
+#define NR_PRODUCERS 4
+#define NR_MESSAGES 10000
+
+static rbgroup_t group;
+static _Atomic size_t nr_consumed;
+
+static void* producer(void* arg)
+{
+    size_t id = (size_t) arg;
+    size_t msg[2] = {id, 0};
+    for (msg[1] = 0; msg[1] < NR_MESSAGES; msg[1]++) {
+        while (ringbuffer_write(ringbuffer_group_lane(&group, id), msg, sizeof(msg)) != SUCCESS);
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg)
+{
+    size_t* next = arg;
+    size_t msg[2];
+    while (atomic_load(&nr_consumed) < NR_PRODUCERS * NR_MESSAGES) {
+        size_t len = sizeof(msg);
+        if (ringbuffer_group_read(&group, msg, &len) != SUCCESS) {
+            continue;
+        }
+        //one consumer only sees part of a lane, but never out of order
+        if (msg[1] < next[msg[0]]) {
+            printf("Error: Test 3 failed. Message %zu of producer %zu out of order\n", msg[1], msg[0]);
+            exit(1);
+        }
+        next[msg[0]] = msg[1] + 1;
+        atomic_fetch_add(&nr_consumed, 1);
+    }
+    return NULL;
+}
+
+static void* parked_reader(void* arg)
+{
+    char buffer[16];
+    size_t len = sizeof(buffer);
+    *(int*) arg = ringbuffer_group_read(&group, buffer, &len);
+    return NULL;
+}
+
+int main()
+{
+    char buffer[100];
+    size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Every producer has its own lane, reads go round-robin over the lanes  *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: round-robin\n");
+
+    if (ringbuffer_group_init(&group, 0, 64, 0, RBUF_GROUP_ROUND_ROBIN) != RINGBUFFER_INVALID ||
+        ringbuffer_group_init(&group, 3, 48, RBUF_POW2, RBUF_GROUP_ROUND_ROBIN) != RINGBUFFER_INVALID ||
+        ringbuffer_group_init(&group, 2, 0, 0, RBUF_GROUP_ROUND_ROBIN) != RINGBUFFER_INVALID ||
+        ringbuffer_group_init(&group, 2, 2, RBUF_VARINT, RBUF_GROUP_ROUND_ROBIN) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID\n");
+        exit(1);
+    }
+    /* the smallest lanes hold one byte with its prefix */
+    if (ringbuffer_group_init(&group, 2, 3, RBUF_VARINT, RBUF_GROUP_ROUND_ROBIN) != SUCCESS
+        || ringbuffer_try_write(ringbuffer_group_lane(&group, 0), "x", 1) != SUCCESS
+        || ringbuffer_try_write(ringbuffer_group_lane(&group, 0), "x", 1) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.1 failed. Expected lanes of 3 bytes to hold one message\n");
+        exit(1);
+    }
+    ringbuffer_group_destroy(&group);
+    if (ringbuffer_group_init(&group, 3, 64, 0, RBUF_GROUP_ROUND_ROBIN) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    if (ringbuffer_group_lane(&group, 1) == ringbuffer_group_lane(&group, 2) ||
+        ringbuffer_group_lane(&group, 1) != ringbuffer_group_lane(&group, 4)) {
+        printf("Error: Test 1.3 failed. Expected lanes modulo 3\n");
+        exit(1);
+    }
+
+    char *msg[3] = {"lane 0", "lane 1", "lane 2"};
+    for (size_t i = 0; i < 3; i++) {
+        ringbuffer_write(ringbuffer_group_lane(&group, i), msg[i], strlen(msg[i]) + 1);
+        ringbuffer_write(ringbuffer_group_lane(&group, i), msg[i], strlen(msg[i]) + 1);
+    }
+    for (size_t i = 0; i < 6; i++) {
+        len = sizeof(buffer);
+        if (ringbuffer_group_read(&group, buffer, &len) != SUCCESS || strcmp(buffer, msg[i % 3]) != 0) {
+            printf("Error: Test 1.4 failed. Expected a message of %s\n", msg[i % 3]);
+            exit(1);
+        }
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_group_read(&group, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 1.5 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    ringbuffer_group_destroy(&group);
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Occupancy drains the fullest lane first, batches stay in one lane     *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: occupancy and batches\n");
+
+    if (ringbuffer_group_init(&group, 3, 128, RBUF_VARINT | RBUF_POW2, RBUF_GROUP_OCCUPANCY) != SUCCESS) {
+        printf("Error: Test 2.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    ringbuffer_write(ringbuffer_group_lane(&group, 0), msg[0], strlen(msg[0]) + 1);
+    for (int i = 0; i < 3; i++) {
+        ringbuffer_write(ringbuffer_group_lane(&group, 2), msg[2], strlen(msg[2]) + 1);
+    }
+
+    size_t offsets[5];
+    size_t nr_read;
+    if (ringbuffer_group_read_batch(&group, buffer, sizeof(buffer), offsets, 4, &nr_read) != SUCCESS || nr_read != 3 ||
+        strcmp(buffer + offsets[2], msg[2]) != 0) {
+        printf("Error: Test 2.2 failed. Expected the three messages of lane 2\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_group_read(&group, buffer, &len) != SUCCESS || strcmp(buffer, msg[0]) != 0) {
+        printf("Error: Test 2.3 failed. Expected the message of lane 0\n");
+        exit(1);
+    }
+    ringbuffer_group_destroy(&group);
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Several producers and consumers, order per producer is kept           *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: threaded\n");
+
+    if (ringbuffer_group_init(&group, 2, 256, 0, RBUF_GROUP_ROUND_ROBIN) != SUCCESS) {
+        printf("Error: Test 3 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    pthread_t producers[NR_PRODUCERS];
+    pthread_t consumers[2];
+    size_t next[2][NR_PRODUCERS] = {{0}};
+    for (size_t i = 0; i < NR_PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, producer, (void*) i);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&consumers[i], NULL, consumer, next[i]);
+    }
+    for (int i = 0; i < NR_PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    ringbuffer_group_destroy(&group);
+
+    printf("  + Test 3 passed\n");
+
+    /*************************************************************************
+     * TEST 4:                                                               *
+     * A reader parked on the empty group wakes up for a message on any lane *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 4: wakeup from every lane\n");
+
+    ringbuffer_group_init(&group, 3, 64, 0, RBUF_GROUP_ROUND_ROBIN);
+    for (size_t i = 0; i < 3; i++) {
+        pthread_t reader;
+        int result;
+        pthread_create(&reader, NULL, parked_reader, &result);
+        usleep(20000);
+        uint64_t start_ns = ringbuffer_now_ns();
+        ringbuffer_write(ringbuffer_group_lane(&group, i), msg[i], strlen(msg[i]) + 1);
+        pthread_join(reader, NULL);
+        if (result != SUCCESS || ringbuffer_now_ns() - start_ns > 100000000) {
+            printf("Error: Test 4 failed. Expected the message of lane %zu right away\n", i);
+            exit(1);
+        }
+    }
+    ringbuffer_group_destroy(&group);
+
+    printf("  + Test 4 passed\n");
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
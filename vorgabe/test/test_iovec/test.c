@@ -0,0 +1,109 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+typedef struct {
+    int from;
+    int to;
+} header_t;
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 50;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    ringbuffer_init(ringbuffer_context, rbuf, rbuf_size);
+
+    header_t header = {3, 7};
+    char *payload = "payload";
+    struct iovec out[2] = {{&header, sizeof(header)}, {payload, strlen(payload) + 1}};
+    size_t message_len = sizeof(header) + strlen(payload) + 1;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Header and payload are written as one message                         *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: gather write\n");
+
+    if (ringbuffer_writev(ringbuffer_context, out, 2) != SUCCESS) {
+        printf("Error: Test 1.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+
+    char buffer[50];
+    size_t len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != message_len ||
+        memcmp(buffer, &header, sizeof(header)) != 0 || strcmp(buffer + sizeof(header), payload) != 0) {
+        printf("Error: Test 1.2 failed. Expected header followed by payload\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * A message is split over several destinations, also across the wrap   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: scatter read\n");
+
+    header_t header_in;
+    char payload_in[20];
+    struct iovec in[2] = {{&header_in, sizeof(header_in)}, {payload_in, sizeof(payload_in)}};
+
+    for (int i = 0; i < 10; i++) {
+        header.from = i;
+        if (ringbuffer_writev(ringbuffer_context, out, 2) != SUCCESS) {
+            printf("Error: Test 2.1 failed. Expected SUCCESS\n");
+            exit(1);
+        }
+        memset(payload_in, 0, sizeof(payload_in));
+        if (ringbuffer_readv(ringbuffer_context, in, 2, &len) != SUCCESS || len != message_len ||
+            header_in.from != i || header_in.to != 7 || strcmp(payload_in, payload) != 0) {
+            printf("Error: Test 2.2 failed. Message %d read wrong\n", i);
+            exit(1);
+        }
+    }
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Destinations that are too small leave the message in the ringbuffer   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: destinations too small\n");
+
+    if (ringbuffer_writev(ringbuffer_context, out, 2) != SUCCESS) {
+        printf("Error: Test 3.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    in[1].iov_len = 2;
+    if (ringbuffer_readv(ringbuffer_context, in, 2, &len) != OUTPUT_BUFFER_TOO_SMALL || len != message_len) {
+        printf("Error: Test 3.2 failed. Expected OUTPUT_BUFFER_TOO_SMALL\n");
+        exit(1);
+    }
+    in[1].iov_len = sizeof(payload_in);
+    if (ringbuffer_readv(ringbuffer_context, in, 2, &len) != SUCCESS || strcmp(payload_in, payload) != 0) {
+        printf("Error: Test 3.3 failed. Expected the message to be still there\n");
+        exit(1);
+    }
+    if (ringbuffer_readv(ringbuffer_context, in, 2, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 3.4 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+
+    printf("  + Test 3 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
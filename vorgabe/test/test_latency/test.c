@@ -0,0 +1,92 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <unistd.h>
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 128;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    rblatency_t latency;
+    char buffer[64];
+    size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Only RBUF_TIMESTAMPS rings measure latency                            *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: timestamps mode\n");
+
+    ringbuffer_init(ringbuffer_context, rbuf, rbuf_size);
+    if (ringbuffer_latency(ringbuffer_context, &latency) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID\n");
+        exit(1);
+    }
+    ringbuffer_destroy(ringbuffer_context);
+
+    if (ringbuffer_init_flags(ringbuffer_context, rbuf, rbuf_size, RBUF_TIMESTAMPS | RBUF_VARINT) != SUCCESS ||
+        ringbuffer_latency(ringbuffer_context, &latency) != SUCCESS || latency.count != 0 || latency.max_ns != 0) {
+        printf("Error: Test 1.2 failed. Expected an empty histogram\n");
+        exit(1);
+    }
+
+    /* the timestamp takes space in the ringbuffer but is not part of the message */
+    ringbuffer_write(ringbuffer_context, "hello", 6);
+    len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 6 || strcmp(buffer, "hello") != 0) {
+        printf("Error: Test 1.3 failed. Message read wrong\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Percentiles separate the fast messages from the slow one              *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: percentiles\n");
+
+    for (int i = 0; i < 199; i++) {
+        ringbuffer_write(ringbuffer_context, "fast", 5);
+        len = sizeof(buffer);
+        ringbuffer_read(ringbuffer_context, buffer, &len);
+    }
+
+    /* the slow one goes through reserve/commit and peek/release */
+    struct iovec vec[2];
+    ringbuffer_write_reserve(ringbuffer_context, 10, vec);
+    ringbuffer_write_commit(ringbuffer_context, 0);
+    usleep(20000);
+    ringbuffer_read_peek(ringbuffer_context, vec);
+    ringbuffer_read_release(ringbuffer_context);
+
+    if (ringbuffer_latency(ringbuffer_context, &latency) != SUCCESS || latency.count != 201) {
+        printf("Error: Test 2.1 failed. Expected 201 messages\n");
+        exit(1);
+    }
+    if (latency.max_ns < 20000000 || latency.p999_ns != latency.max_ns) {
+        printf("Error: Test 2.2 failed. Expected the slow message as p99.9 and max\n");
+        exit(1);
+    }
+    if (latency.p50_ns > latency.p99_ns || latency.p99_ns >= 20000000) {
+        printf("Error: Test 2.3 failed. Expected p50 <= p99 below the slow message\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <unistd.h>
+
+#define NUMBER_OF_MESSAGES 10000
+#define MSG_SIZE 300  // does not divide the page size, so messages straddle the end
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    if (ringbuffer_context == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Both halves of the mapping show the same memory                       *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: mirrored mapping\n");
+
+    if (ringbuffer_init_mirrored(ringbuffer_context, 1, 0) != SUCCESS) {
+        printf("Error: Test 1 failed. Could not map ringbuffer\n");
+        exit(1);
+    }
+
+    size_t size = ringbuffer_context->end - ringbuffer_context->begin;
+    if (size != (size_t) sysconf(_SC_PAGESIZE)) {
+        printf("Error: Test 1 failed. Size not rounded up to page size\n");
+        exit(1);
+    }
+
+    ringbuffer_context->begin[3] = 'x';
+    if (ringbuffer_context->end[3] != 'x') {
+        printf("Error: Test 1 failed. Second mapping does not mirror the first\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Messages and length prefixes crossing the end                         *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: write and read across the end\n");
+
+    unsigned char msg[MSG_SIZE];
+    unsigned char buf[MSG_SIZE];
+    for (size_t i = 0; i < NUMBER_OF_MESSAGES; i++) {
+        size_t msg_len = 1 + (i * 7) % MSG_SIZE;
+        memset(msg, (int) i, msg_len);
+        if (ringbuffer_write(ringbuffer_context, msg, msg_len) != SUCCESS) {
+            printf("Error: Test 2 failed. Write %zu failed\n", i);
+            exit(1);
+        }
+
+        size_t buf_len = MSG_SIZE;
+        if (ringbuffer_read(ringbuffer_context, buf, &buf_len) != SUCCESS) {
+            printf("Error: Test 2 failed. Read %zu failed\n", i);
+            exit(1);
+        }
+        if (buf_len != msg_len || memcmp(buf, msg, msg_len) != 0) {
+            printf("Error: Test 2 failed. Message %zu corrupted\n", i);
+            exit(1);
+        }
+        if (ringbuffer_context->read < ringbuffer_context->begin || ringbuffer_context->read >= ringbuffer_context->end) {
+            printf("Error: Test 2 failed. Read pointer outside of ringbuffer\n");
+            exit(1);
+        }
+    }
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(ringbuffer_context);
+
+    printf("  + Test 2 passed\n");
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "../include/ringbuf_mpmc.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define NUMBER_OF_PRODUCERS 4
+#define NUMBER_OF_CONSUMERS 4
+#define MESSAGES_PER_PRODUCER 50000
+#define SLOT_SIZE 32
+#define RBUF_SIZE (16 * 64)  // 16 slots
+
+typedef struct {
+    size_t producer;
+    size_t seq;
+} msg_t;
+
+mpmc_rbctx_t rb;
+_Atomic size_t consumed = 0;
+size_t last_seq[NUMBER_OF_CONSUMERS][NUMBER_OF_PRODUCERS];
+size_t received[NUMBER_OF_PRODUCERS];
+pthread_mutex_t received_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+void *producer(void *arg)
+{
+    size_t id = (size_t) arg;
+    for (size_t i = 1; i <= MESSAGES_PER_PRODUCER; i++) {
+        msg_t msg = {id, i};
+        while (mpmc_ringbuffer_write(&rb, &msg, sizeof(msg)) != SUCCESS) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void *consumer(void *arg)
+{
+    size_t id = (size_t) arg;
+    while (atomic_load(&consumed) < NUMBER_OF_PRODUCERS * MESSAGES_PER_PRODUCER) {
+        msg_t msg;
+        size_t len = sizeof(msg);
+        if (mpmc_ringbuffer_read(&rb, &msg, &len) != SUCCESS) {
+            sched_yield();
+            continue;
+        }
+        atomic_fetch_add(&consumed, 1);
+        /* messages of one producer are seen in order by every single consumer */
+        if (len != sizeof(msg) || msg.seq <= last_seq[id][msg.producer]) {
+            printf("Error: message out of order or corrupted\n");
+            exit(1);
+        }
+        last_seq[id][msg.producer] = msg.seq;
+        pthread_mutex_lock(&received_mtx);
+        received[msg.producer]++;
+        pthread_mutex_unlock(&received_mtx);
+    }
+    return NULL;
+}
+
+int main()
+{
+    uint8_t *rbuf = aligned_alloc(RBUF_CACHELINE, RBUF_SIZE);
+    if (rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Single threaded: empty, full, oversized and too small buffer          *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: empty, full, oversized message and too small buffer\n");
+
+    if (mpmc_ringbuffer_init(&rb, rbuf, 64, SLOT_SIZE) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for a single slot\n");
+        exit(1);
+    }
+    if (mpmc_ringbuffer_init(&rb, rbuf, RBUF_SIZE, SLOT_SIZE) != SUCCESS) {
+        printf("Error: Test 1.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+
+    char buf[SLOT_SIZE + 1];
+    size_t buf_len = sizeof(buf);
+    if (mpmc_ringbuffer_read(&rb, buf, &buf_len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 1.2 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    if (mpmc_ringbuffer_write(&rb, buf, SLOT_SIZE + 1) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.3 failed. Expected RINGBUFFER_INVALID for an oversized message\n");
+        exit(1);
+    }
+    for (int i = 0; i < 16; i++) {
+        if (mpmc_ringbuffer_write(&rb, "slot", 5) != SUCCESS) {
+            printf("Error: Test 1.4 failed. Expected SUCCESS\n");
+            exit(1);
+        }
+    }
+    if (mpmc_ringbuffer_write(&rb, "slot", 5) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.4 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+
+    buf_len = 2;
+    if (mpmc_ringbuffer_read(&rb, buf, &buf_len) != OUTPUT_BUFFER_TOO_SMALL || buf_len != 5) {
+        printf("Error: Test 1.5 failed. Expected OUTPUT_BUFFER_TOO_SMALL with required size\n");
+        exit(1);
+    }
+    for (int i = 0; i < 16; i++) {
+        buf_len = sizeof(buf);
+        if (mpmc_ringbuffer_read(&rb, buf, &buf_len) != SUCCESS || strcmp(buf, "slot") != 0) {
+            printf("Error: Test 1.5 failed. Expected to read every slot back\n");
+            exit(1);
+        }
+    }
+    mpmc_ringbuffer_destroy(&rb);
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Several producers and consumers, nothing lost or duplicated           *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: %d producers and %d consumers\n", NUMBER_OF_PRODUCERS, NUMBER_OF_CONSUMERS);
+
+    mpmc_ringbuffer_init(&rb, rbuf, RBUF_SIZE, SLOT_SIZE);
+    pthread_t p[NUMBER_OF_PRODUCERS], c[NUMBER_OF_CONSUMERS];
+    for (size_t i = 0; i < NUMBER_OF_CONSUMERS; i++) {
+        pthread_create(&c[i], NULL, consumer, (void *) i);
+    }
+    for (size_t i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        pthread_create(&p[i], NULL, producer, (void *) i);
+    }
+    for (size_t i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        pthread_join(p[i], NULL);
+    }
+    for (size_t i = 0; i < NUMBER_OF_CONSUMERS; i++) {
+        pthread_join(c[i], NULL);
+    }
+
+    for (size_t i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        if (received[i] != MESSAGES_PER_PRODUCER) {
+            printf("Error: Test 2 failed. Producer %zu: expected %d messages, got %zu\n", i, MESSAGES_PER_PRODUCER, received[i]);
+            exit(1);
+        }
+    }
+    mpmc_ringbuffer_destroy(&rb);
+    printf("  + Test 2 passed\n");
+
+    free(rbuf);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
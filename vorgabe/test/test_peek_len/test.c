@@ -0,0 +1,72 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+#define RBUF_SIZE 256
+
+int main()
+{
+    rbctx_t ringbuffer_context;
+    char rbuf[RBUF_SIZE];
+    char small[8];
+    char large[64];
+    size_t len;
+
+    ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_VARINT);
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * A too small buffer is reported right away with the required size     *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: no stall on a too small buffer\n");
+
+    ringbuffer_write(&ringbuffer_context, "a message of 27 characters", 27);
+    uint64_t start_ns = ringbuffer_now_ns();
+    len = sizeof(small);
+    if (ringbuffer_read(&ringbuffer_context, small, &len) != OUTPUT_BUFFER_TOO_SMALL || len != 27) {
+        printf("Error: Test 1.1 failed. Expected OUTPUT_BUFFER_TOO_SMALL with length 27\n");
+        exit(1);
+    }
+    if (ringbuffer_now_ns() - start_ns > 100000000) {
+        printf("Error: Test 1.2 failed. Expected OUTPUT_BUFFER_TOO_SMALL without waiting\n");
+        exit(1);
+    }
+    if (ringbuffer_read(&ringbuffer_context, large, &len) != SUCCESS || strcmp(large, "a message of 27 characters") != 0) {
+        printf("Error: Test 1.3 failed. Expected to read the message with the required size\n");
+        exit(1);
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * ringbuffer_peek_len                                                   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: ringbuffer_peek_len\n");
+
+    if (ringbuffer_peek_len(&ringbuffer_context, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.1 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    ringbuffer_write(&ringbuffer_context, large, 50);
+    ringbuffer_write(&ringbuffer_context, "short", 6);
+    size_t expected[2] = {50, 6};
+    for (int i = 0; i < 2; i++) {
+        if (ringbuffer_peek_len(&ringbuffer_context, &len) != SUCCESS || len != expected[i]) {
+            printf("Error: Test 2.2 failed. Expected length %zu\n", expected[i]);
+            exit(1);
+        }
+        /* peeking doesn't consume */
+        if (ringbuffer_peek_len(&ringbuffer_context, &len) != SUCCESS || len != expected[i]) {
+            printf("Error: Test 2.3 failed. Expected length %zu again\n", expected[i]);
+            exit(1);
+        }
+        len = sizeof(large);
+        ringbuffer_read(&ringbuffer_context, large, &len);
+    }
+    printf("  + Test 2 passed\n");
+
+    ringbuffer_destroy(&ringbuffer_context);
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "../include/ringbuf_persist.h"
+#include <stdio.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/wait.h>
+
+#define RBUF_SIZE 64
+
+//read the next message and compare it to "msg <i>"
+void expect_message(persist_rbctx_t *ringbuffer_context, int i, const char *test)
+{
+    char expected[16];
+    char buffer[16];
+    size_t len = sizeof(buffer);
+    snprintf(expected, sizeof(expected), "msg %02d", i);
+    if (persist_ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 7 || strcmp(buffer, expected) != 0) {
+        printf("Error: Test %s failed. Expected '%s'\n", test, expected);
+        exit(1);
+    }
+}
+
+void write_message(persist_rbctx_t *ringbuffer_context, int i)
+{
+    char message[16];
+    snprintf(message, sizeof(message), "msg %02d", i);
+    if (persist_ringbuffer_write(ringbuffer_context, message, 7) != SUCCESS) {
+        printf("Error: writing '%s' failed\n", message);
+        exit(1);
+    }
+}
+
+int main()
+{
+    persist_rbctx_t ringbuffer_context;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/ringbuf-persist-%d", (int) getpid());
+    unlink(path);
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Messages that were not read survive closing and reopening             *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: reopen\n");
+
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT | RBUF_TIMESTAMPS, 0) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for RBUF_TIMESTAMPS\n");
+        exit(1);
+    }
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 1) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    /* wrap around once, 8 messages of 7 + 1 fill the ring */
+    for (int i = 0; i < 6; i++) {
+        write_message(&ringbuffer_context, i);
+    }
+    for (int i = 0; i < 6; i++) {
+        expect_message(&ringbuffer_context, i, "1.3");
+    }
+    for (int i = 6; i < 11; i++) {
+        write_message(&ringbuffer_context, i);
+    }
+    expect_message(&ringbuffer_context, 6, "1.4");
+    rbstats_t stats;
+    ringbuffer_stats(&ringbuffer_context.ring, &stats);
+    if (stats.messages_in != 11 || stats.messages_out != 7 || stats.high_water != 6 * 8) {
+        printf("Error: Test 1.4 failed. Expected 11 messages in, 7 out and at most 6 stored\n");
+        exit(1);
+    }
+    persist_ringbuffer_close(&ringbuffer_context);
+
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE * 2, RBUF_VARINT | RBUF_POW2, 0) != RINGBUFFER_INVALID
+        || persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT, 0) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.5 failed. Expected RINGBUFFER_INVALID for another size or other flags\n");
+        exit(1);
+    }
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != SUCCESS) {
+        printf("Error: Test 1.6 failed. Expected to reopen the file\n");
+        exit(1);
+    }
+    for (int i = 7; i < 11; i++) {
+        expect_message(&ringbuffer_context, i, "1.7");
+    }
+    char buffer[16];
+    size_t len = sizeof(buffer);
+    if (ringbuffer_try_read(&ringbuffer_context.ring, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 1.8 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * A killed writer leaves its committed messages and nothing else        *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: crash\n");
+
+    write_message(&ringbuffer_context, 20);
+    persist_ringbuffer_close(&ringbuffer_context);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        persist_rbctx_t child;
+        if (persist_ringbuffer_open(&child, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != SUCCESS) {
+            _exit(1);
+        }
+        char buffer[16];
+        size_t len = sizeof(buffer);
+        persist_ringbuffer_read(&child, buffer, &len);
+        write_message(&child, 21);
+        write_message(&child, 22);
+        /* bytes of a message that was never committed */
+        memcpy(child.ring.write, "\x07garbage", 8);
+        kill(getpid(), SIGKILL);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFSIGNALED(status)) {
+        printf("Error: Test 2.1 failed. Expected the writer to be killed\n");
+        exit(1);
+    }
+
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != SUCCESS) {
+        printf("Error: Test 2.2 failed. Expected to recover the file\n");
+        exit(1);
+    }
+    expect_message(&ringbuffer_context, 21, "2.3");
+    expect_message(&ringbuffer_context, 22, "2.3");
+    len = sizeof(buffer);
+    if (ringbuffer_try_read(&ringbuffer_context.ring, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.4 failed. Expected the uncommitted message to be gone\n");
+        exit(1);
+    }
+    persist_ringbuffer_close(&ringbuffer_context);
+    unlink(path);
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * One process at a time, files only appear with a complete header       *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: locking and creation\n");
+
+    persist_rbctx_t second;
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != SUCCESS
+        || persist_ringbuffer_open(&second, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != RINGBUFFER_INVALID) {
+        printf("Error: Test 3.1 failed. Expected RINGBUFFER_INVALID while the file is open\n");
+        exit(1);
+    }
+    persist_ringbuffer_close(&ringbuffer_context);
+    if (persist_ringbuffer_open(&second, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != SUCCESS) {
+        printf("Error: Test 3.2 failed. Expected to open the file after the close\n");
+        exit(1);
+    }
+    persist_ringbuffer_close(&second);
+    unlink(path);
+
+    char pattern[80];
+    snprintf(pattern, sizeof(pattern), "%s.*", path);
+    glob_t leftovers;
+    if (glob(pattern, 0, NULL, &leftovers) != GLOB_NOMATCH) {
+        printf("Error: Test 3.3 failed. Expected no temporary files next to the ringbuffer\n");
+        exit(1);
+    }
+
+    /* what a crash between creating and writing the header used to leave */
+    close(open(path, O_RDWR | O_CREAT, 0600));
+    if (persist_ringbuffer_open(&ringbuffer_context, path, RBUF_SIZE, RBUF_VARINT | RBUF_POW2, 0) != RINGBUFFER_INVALID) {
+        printf("Error: Test 3.4 failed. Expected RINGBUFFER_INVALID for an empty file\n");
+        exit(1);
+    }
+    unlink(path);
+    printf("  + Test 3 passed\n");
+
+    printf("All tests passed\n");
+    return 0;
+}
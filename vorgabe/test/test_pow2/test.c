@@ -0,0 +1,102 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 64;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * RBUF_POW2 only accepts power-of-two sizes                             *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: power-of-two size\n");
+
+    if (ringbuffer_init_flags(ringbuffer_context, rbuf, 48, RBUF_POW2) != RINGBUFFER_INVALID
+        || ringbuffer_init_flags(ringbuffer_context, rbuf, 0, RBUF_POW2) != RINGBUFFER_INVALID
+        || ringbuffer_init_flags(ringbuffer_context, rbuf, 0, 0) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for 48 and 0 bytes\n");
+        exit(1);
+    }
+    if (ringbuffer_init_flags(ringbuffer_context, rbuf, rbuf_size, RBUF_POW2) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * The whole memory is usable                                            *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: full capacity\n");
+
+    char msg[64 - sizeof(size_t)];
+    for (size_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = (char) i;
+    }
+    if (ringbuffer_write(ringbuffer_context, msg, sizeof(msg)) != SUCCESS) {
+        printf("Error: Test 2.1 failed. Expected the message to fill the ringbuffer\n");
+        exit(1);
+    }
+    if (ringbuffer_try_write(ringbuffer_context, msg, 0) != RINGBUFFER_FULL) {
+        printf("Error: Test 2.2 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+
+    char buffer[64];
+    size_t len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != sizeof(msg) || memcmp(buffer, msg, len) != 0) {
+        printf("Error: Test 2.3 failed. Message read wrong\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_try_read(ringbuffer_context, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.4 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Head and tail count every byte across many wraps                      *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: byte counters\n");
+
+    for (size_t i = 0; i < 1000; i++) {
+        size_t n = i % 20;
+        if (ringbuffer_try_write(ringbuffer_context, msg + i % 7, n) != SUCCESS) {
+            printf("Error: Test 3.1 failed. Write %zu failed\n", i);
+            exit(1);
+        }
+        len = sizeof(buffer);
+        if (ringbuffer_try_read(ringbuffer_context, buffer, &len) != SUCCESS || len != n || memcmp(buffer, msg + i % 7, n) != 0) {
+            printf("Error: Test 3.2 failed. Read %zu wrong\n", i);
+            exit(1);
+        }
+    }
+    uint64_t bytes = 64 + 1000 * sizeof(size_t) + 19 * 1000 / 2;
+    if (ringbuffer_context->head != bytes || ringbuffer_context->tail != bytes) {
+        printf("Error: Test 3.3 failed. Expected %lu bytes through the ringbuffer\n", (unsigned long) bytes);
+        exit(1);
+    }
+
+    printf("  + Test 3 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "../include/ringbuf_prio.h"
+#include <stdio.h>
+
+int main()
+{
+    prio_rbctx_t ringbuffer_context;
+    size_t lane_sizes[2] = {32, 64};
+    char *rbuf = malloc(lane_sizes[0] + lane_sizes[1]);
+    if (rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    char buffer[32];
+    size_t len;
+    size_t prio;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Strict priority, bulk traffic can't take the space of lane 0          *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: strict priority\n");
+
+    if (prio_ringbuffer_init(&ringbuffer_context, rbuf, lane_sizes, NULL, 2, RBUF_VARINT, RBUF_PRIO_WEIGHTED) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID without weights\n");
+        exit(1);
+    }
+    if (prio_ringbuffer_init(&ringbuffer_context, rbuf, lane_sizes, NULL, 2, RBUF_VARINT, RBUF_PRIO_STRICT) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+
+    /* lane 1 holds 63 bytes, 9 messages of 6 + 1 */
+    for (int i = 0; i < 9; i++) {
+        prio_ringbuffer_write(&ringbuffer_context, 1, "bulk.", 6);
+    }
+    if (prio_ringbuffer_write(&ringbuffer_context, 1, "bulk.", 6) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.3 failed. Expected lane 1 to be full\n");
+        exit(1);
+    }
+    if (prio_ringbuffer_write(&ringbuffer_context, 0, "ctrl", 5) != SUCCESS ||
+        prio_ringbuffer_write(&ringbuffer_context, 2, "none", 5) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.4 failed. Expected lane 0 to have room and no lane 2\n");
+        exit(1);
+    }
+
+    len = sizeof(buffer);
+    if (prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio) != SUCCESS || prio != 0 || strcmp(buffer, "ctrl") != 0) {
+        printf("Error: Test 1.5 failed. Expected the lane 0 message first\n");
+        exit(1);
+    }
+    for (int i = 0; i < 9; i++) {
+        len = sizeof(buffer);
+        if (prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio) != SUCCESS || prio != 1) {
+            printf("Error: Test 1.6 failed. Expected the lane 1 messages\n");
+            exit(1);
+        }
+    }
+    prio_ringbuffer_destroy(&ringbuffer_context);
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Weighted lanes are served in ratio of their weights                   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: weighted\n");
+
+    unsigned weights[2] = {3, 1};
+    if (prio_ringbuffer_init(&ringbuffer_context, rbuf, lane_sizes, weights, 2, RBUF_VARINT, RBUF_PRIO_WEIGHTED) != SUCCESS) {
+        printf("Error: Test 2.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    for (int i = 0; i < 8; i++) {
+        prio_ringbuffer_write(&ringbuffer_context, 0, "a", 2);
+        prio_ringbuffer_write(&ringbuffer_context, 1, "b", 2);
+    }
+
+    size_t served[2] = {0, 0};
+    for (int i = 0; i < 8; i++) {
+        len = sizeof(buffer);
+        prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio);
+        served[prio]++;
+    }
+    if (served[0] != 6 || served[1] != 2) {
+        printf("Error: Test 2.2 failed. Expected 6 reads of lane 0 and 2 of lane 1, got %zu and %zu\n", served[0], served[1]);
+        exit(1);
+    }
+
+    /* an empty lane doesn't save up credit, the other one is served alone */
+    for (int i = 0; i < 2; i++) {
+        len = sizeof(buffer);
+        prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio);
+    }
+    for (int i = 0; i < 6; i++) {
+        len = sizeof(buffer);
+        if (prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio) != SUCCESS || prio != 1) {
+            printf("Error: Test 2.3 failed. Expected the rest of lane 1\n");
+            exit(1);
+        }
+    }
+    prio_ringbuffer_destroy(&ringbuffer_context);
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Wait strategy and counters of all lanes                               *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: flags and stats\n");
+
+    if (prio_ringbuffer_init(&ringbuffer_context, rbuf, lane_sizes, NULL, 2, RBUF_VARINT | RBUF_EVENTFD, RBUF_PRIO_STRICT) != RINGBUFFER_INVALID
+        || prio_ringbuffer_init(&ringbuffer_context, rbuf, lane_sizes, NULL, 2, RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF, RBUF_PRIO_STRICT) != RINGBUFFER_INVALID) {
+        printf("Error: Test 3.1 failed. Expected RINGBUFFER_INVALID for lane fds and both wait strategies\n");
+        exit(1);
+    }
+    if (prio_ringbuffer_init(&ringbuffer_context, rbuf, lane_sizes, NULL, 2, RBUF_VARINT | RBUF_WAIT_BACKOFF, RBUF_PRIO_STRICT) != SUCCESS) {
+        printf("Error: Test 3.2 failed. Expected SUCCESS with RBUF_WAIT_BACKOFF\n");
+        exit(1);
+    }
+    prio_ringbuffer_write(&ringbuffer_context, 0, "high", 5);
+    prio_ringbuffer_write(&ringbuffer_context, 1, "low", 4);
+    for (int i = 0; i < 2; i++) {
+        len = sizeof(buffer);
+        prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio);
+    }
+    len = sizeof(buffer);
+    if (prio_ringbuffer_read(&ringbuffer_context, buffer, &len, &prio) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 3.3 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    rbstats_t stats;
+    prio_ringbuffer_stats(&ringbuffer_context, &stats);
+    if (stats.messages_in != 2 || stats.messages_out != 2 || stats.bytes_in != 9 || stats.high_water != 11
+        || stats.empty != 1 || stats.timeouts != 1 || stats.wait_ns == 0) {
+        printf("Error: Test 3.4 failed. Expected the counters of both lanes and the timed out wait\n");
+        exit(1);
+    }
+    prio_ringbuffer_destroy(&ringbuffer_context);
+    printf("  + Test 3 passed\n");
+
+    free(rbuf);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "../include/ringbuf_shm.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define NR_MESSAGES 1000
+
+int main()
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/rbuf_test_%d", (int) getpid());
+
+    shm_rbctx_t ringbuffer_context;
+    shm_rbctx_t other;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Create and open by name                                               *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: create and open\n");
+
+    if (shm_ringbuffer_open(&other, name) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_INVALID for a missing ringbuffer\n");
+        exit(1);
+    }
+    if (shm_ringbuffer_create(&ringbuffer_context, name, 256) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    if (shm_ringbuffer_create(&other, name, 256) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1.3 failed. Expected RINGBUFFER_INVALID for an existing ringbuffer\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * A producer process feeds the consumer                                 *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: producer process\n");
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (shm_ringbuffer_open(&other, name) != SUCCESS) {
+            _exit(1);
+        }
+        for (int i = 0; i < NR_MESSAGES; i++) {
+            if (shm_ringbuffer_write(&other, &i, sizeof(i)) != SUCCESS) {
+                _exit(1);
+            }
+        }
+        shm_ringbuffer_close(&other);
+        _exit(0);
+    }
+
+    for (int i = 0; i < NR_MESSAGES; i++) {
+        int msg;
+        size_t len = sizeof(msg);
+        if (shm_ringbuffer_read(&ringbuffer_context, &msg, &len) != SUCCESS || len != sizeof(msg) || msg != i) {
+            printf("Error: Test 2.1 failed. Expected message %d\n", i);
+            exit(1);
+        }
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("Error: Test 2.2 failed. Producer failed\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * A producer that dies holding the mutex doesn't wedge the consumer     *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: crashed producer\n");
+
+    pid = fork();
+    if (pid == 0) {
+        shm_ringbuffer_open(&other, name);
+        shm_ringbuffer_write(&other, "before", 7);
+        pthread_mutex_lock(&other.ctrl->mtx);
+        _exit(0);
+    }
+    waitpid(pid, &status, 0);
+
+    char buffer[16];
+    size_t len = sizeof(buffer);
+    if (shm_ringbuffer_read(&ringbuffer_context, buffer, &len) != SUCCESS || strcmp(buffer, "before") != 0) {
+        printf("Error: Test 3.1 failed. Expected the message written before the crash\n");
+        exit(1);
+    }
+    if (shm_ringbuffer_write(&ringbuffer_context, "after", 6) != SUCCESS) {
+        printf("Error: Test 3.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (shm_ringbuffer_read(&ringbuffer_context, buffer, &len) != SUCCESS || strcmp(buffer, "after") != 0) {
+        printf("Error: Test 3.3 failed. Expected the message written after the crash\n");
+        exit(1);
+    }
+
+    printf("  + Test 3 passed\n");
+
+    shm_ringbuffer_destroy(&ringbuffer_context);
+    if (shm_ringbuffer_open(&other, name) != RINGBUFFER_INVALID) {
+        printf("Error: destroy failed to unlink %s\n", name);
+        exit(1);
+    }
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
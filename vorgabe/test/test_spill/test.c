@@ -0,0 +1,230 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <limits.h>
+
+#define RBUF_SIZE 32    // bytes, holds 3 messages of 7 + 1
+
+//read the next message and compare it to "msg <i>"
+void expect_message(rbctx_t *ringbuffer_context, int i, const char *test)
+{
+    char expected[16];
+    char buffer[16];
+    size_t len = sizeof(buffer);
+    snprintf(expected, sizeof(expected), "msg %02d", i);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 7 || strcmp(buffer, expected) != 0) {
+        printf("Error: Test %s failed. Expected '%s'\n", test, expected);
+        exit(1);
+    }
+}
+
+void write_message(rbctx_t *ringbuffer_context, int i)
+{
+    char message[16];
+    snprintf(message, sizeof(message), "msg %02d", i);
+    if (ringbuffer_try_write(ringbuffer_context, message, 7) != SUCCESS) {
+        printf("Error: writing '%s' failed\n", message);
+        exit(1);
+    }
+}
+
+int main()
+{
+    rbctx_t ringbuffer_context;
+    char rbuf[RBUF_SIZE];
+    rbstats_t stats;
+
+    ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_VARINT);
+    if (ringbuffer_spill(&ringbuffer_context, "/nonexistent", 4096) != RINGBUFFER_INVALID) {
+        printf("Error: Expected RINGBUFFER_INVALID for a missing directory\n");
+        exit(1);
+    }
+    if (ringbuffer_spill(&ringbuffer_context, "/tmp", 4096) != SUCCESS) {
+        printf("Error: ringbuffer_spill failed\n");
+        exit(1);
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Writes beyond the memory spill and come back in order                 *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: spill and drain\n");
+
+    for (int i = 0; i < 20; i++) {
+        write_message(&ringbuffer_context, i);
+    }
+    ringbuffer_stats(&ringbuffer_context, &stats);
+    if (stats.spilled != 17) {
+        printf("Error: Test 1.1 failed. Expected 17 spilled messages, got %llu\n", (unsigned long long) stats.spilled);
+        exit(1);
+    }
+    for (int i = 0; i < 10; i++) {
+        expect_message(&ringbuffer_context, i, "1.2");
+    }
+
+    char buffer[256];
+    size_t offsets[11];
+    size_t nr_read;
+    if (ringbuffer_read_batch(&ringbuffer_context, buffer, sizeof(buffer), offsets, 10, &nr_read) != SUCCESS || nr_read != 10) {
+        printf("Error: Test 1.3 failed. Expected a batch of the 10 remaining messages\n");
+        exit(1);
+    }
+    for (int i = 0; i < 10; i++) {
+        char expected[16];
+        snprintf(expected, sizeof(expected), "msg %02d", i + 10);
+        if (strcmp(buffer + offsets[i], expected) != 0) {
+            printf("Error: Test 1.4 failed. Expected '%s' in the batch\n", expected);
+            exit(1);
+        }
+    }
+    if (ringbuffer_context.spill_head != ringbuffer_context.spill_tail) {
+        printf("Error: Test 1.5 failed. Expected the spill file to be drained\n");
+        exit(1);
+    }
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Room in memory doesn't let later messages overtake spilled ones       *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: order across memory and spill file\n");
+
+    for (int i = 0; i < 5; i++) {
+        write_message(&ringbuffer_context, i);
+    }
+    expect_message(&ringbuffer_context, 0, "2.1");
+    write_message(&ringbuffer_context, 5);
+    for (int i = 1; i < 4; i++) {
+        expect_message(&ringbuffer_context, i, "2.2");
+    }
+
+    /* msg 04 is the oldest one now and it is in the spill file */
+    struct iovec vec[2];
+    if (ringbuffer_read_peek(&ringbuffer_context, vec) != SUCCESS || vec[0].iov_len != 7 || vec[1].iov_len != 0
+        || strcmp(vec[0].iov_base, "msg 04") != 0) {
+        printf("Error: Test 2.3 failed. Expected to peek 'msg 04' from the spill file\n");
+        exit(1);
+    }
+    ringbuffer_read_release(&ringbuffer_context);
+    expect_message(&ringbuffer_context, 5, "2.4");
+
+    size_t len = sizeof(buffer);
+    if (ringbuffer_try_read(&ringbuffer_context, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.5 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+    printf("  + Test 2 passed\n");
+    ringbuffer_destroy(&ringbuffer_context);
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * A full spill file reports RINGBUFFER_FULL                             *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: full spill file\n");
+
+    ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_VARINT);
+    /* 64 bytes hold 2 spilled messages of 24 + 7 */
+    ringbuffer_spill(&ringbuffer_context, "/tmp", 64);
+    for (int i = 0; i < 5; i++) {
+        write_message(&ringbuffer_context, i);
+    }
+    if (ringbuffer_try_write(&ringbuffer_context, "msg 05", 7) != RINGBUFFER_FULL) {
+        printf("Error: Test 3.1 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+    for (int i = 0; i < 5; i++) {
+        expect_message(&ringbuffer_context, i, "3.2");
+    }
+    printf("  + Test 3 passed\n");
+
+    /*************************************************************************
+     * TEST 4:                                                               *
+     * Memory is used again while the file holds messages and the file      *
+     * reuses the space readers freed, it never has to drain completely     *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 4: memory and spill file as rings\n");
+
+    /* memory holds msg 00-02, the file msg 03-04, 2 spilled in test 3 */
+    for (int i = 0; i < 5; i++) {
+        write_message(&ringbuffer_context, i);
+    }
+    int next_write = 5;
+    int next_read = 0;
+    for (int cycle = 0; cycle < 10; cycle++) {
+        /* the memory messages are older than the spilled ones, their room is reused */
+        for (int i = 0; i < 3; i++) {
+            expect_message(&ringbuffer_context, next_read++, "4.1");
+            write_message(&ringbuffer_context, next_write++);
+        }
+        /* then the spilled ones, the file is full so the writes wrap around in it */
+        for (int i = 0; i < 2; i++) {
+            char expected[16];
+            char peeked[16];
+            snprintf(expected, sizeof(expected), "msg %02d", next_read++);
+            if (ringbuffer_read_peek(&ringbuffer_context, vec) != SUCCESS || vec[0].iov_len + vec[1].iov_len != 7) {
+                printf("Error: Test 4.2 failed. Expected to peek '%s'\n", expected);
+                exit(1);
+            }
+            memcpy(peeked, vec[0].iov_base, vec[0].iov_len);
+            memcpy(peeked + vec[0].iov_len, vec[1].iov_base, vec[1].iov_len);
+            if (strcmp(peeked, expected) != 0) {
+                printf("Error: Test 4.3 failed. Expected to peek '%s', got '%s'\n", expected, peeked);
+                exit(1);
+            }
+            ringbuffer_read_release(&ringbuffer_context);
+            write_message(&ringbuffer_context, next_write++);
+        }
+    }
+    ringbuffer_stats(&ringbuffer_context, &stats);
+    if (stats.spilled != 2 + 2 + 2 * 10) {
+        printf("Error: Test 4.4 failed. Expected 24 spilled messages, got %llu\n", (unsigned long long) stats.spilled);
+        exit(1);
+    }
+    while (next_read < next_write) {
+        expect_message(&ringbuffer_context, next_read++, "4.5");
+    }
+    printf("  + Test 4 passed\n");
+    ringbuffer_destroy(&ringbuffer_context);
+
+    /*************************************************************************
+     * TEST 5:                                                               *
+     * ringbuffer_write_blocking takes messages only the spill file fits    *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 5: message larger than the memory\n");
+
+    char long_dir[PATH_MAX + 1];
+    memset(long_dir, 'd', PATH_MAX);
+    long_dir[PATH_MAX] = '\0';
+    ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_VARINT);
+    if (ringbuffer_spill(&ringbuffer_context, long_dir, 4096) != RINGBUFFER_INVALID) {
+        printf("Error: Test 5.1 failed. Expected RINGBUFFER_INVALID for a path longer than PATH_MAX\n");
+        exit(1);
+    }
+    char big[100];
+    memset(big, 'b', sizeof(big));
+    if (ringbuffer_write_blocking(&ringbuffer_context, big, sizeof(big)) != RINGBUFFER_INVALID) {
+        printf("Error: Test 5.2 failed. Expected RINGBUFFER_INVALID without a spill file\n");
+        exit(1);
+    }
+    ringbuffer_spill(&ringbuffer_context, "/tmp", 4096);
+    if (ringbuffer_write_blocking(&ringbuffer_context, big, sizeof(big)) != SUCCESS) {
+        printf("Error: Test 5.3 failed. Expected the spill file to take 100 bytes\n");
+        exit(1);
+    }
+    char back[sizeof(big)];
+    len = sizeof(back);
+    if (ringbuffer_read(&ringbuffer_context, back, &len) != SUCCESS || len != sizeof(big)
+        || memcmp(back, big, sizeof(big)) != 0) {
+        printf("Error: Test 5.4 failed. Expected the 100 bytes back\n");
+        exit(1);
+    }
+    printf("  + Test 5 passed\n");
+    ringbuffer_destroy(&ringbuffer_context);
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "../include/ringbuf_spsc.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#define NUMBER_OF_MESSAGES 100000
+#define RBUF_SIZE 500  // bytes, produces plenty of wrap arounds
+
+typedef struct {
+    size_t id;
+    char text[20];
+} msg_t;
+
+void *producer(void *arg)
+{
+    spsc_rbctx_t *rb = arg;
+    for (size_t i = 0; i < NUMBER_OF_MESSAGES; i++) {
+        msg_t msg = {.id = i};
+        size_t msg_len = sizeof(size_t) + 1 + (i % sizeof(msg.text)); // vary the message size
+        memset(msg.text, 'a' + (i % 26), sizeof(msg.text));
+        while (spsc_ringbuffer_write(rb, &msg, msg_len) != SUCCESS) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+int main()
+{
+    spsc_rbctx_t *rb = aligned_alloc(RBUF_CACHELINE, sizeof(spsc_rbctx_t));
+    uint8_t *rbuf = malloc(RBUF_SIZE);
+    if (rb == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Empty, full and output buffer too small                               *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: empty, full and too small buffer\n");
+
+    spsc_ringbuffer_init(rb, rbuf, 32);
+    char buf[32];
+    size_t buf_len = sizeof(buf);
+    if (spsc_ringbuffer_read(rb, buf, &buf_len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 1.1 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+
+    char msg[] = "0123456789abcdef";
+    if (spsc_ringbuffer_write(rb, msg, sizeof(msg)) != SUCCESS) {
+        printf("Error: Test 1.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    if (spsc_ringbuffer_write(rb, msg, sizeof(msg)) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.2 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+
+    buf_len = 4;
+    if (spsc_ringbuffer_read(rb, buf, &buf_len) != OUTPUT_BUFFER_TOO_SMALL || buf_len != sizeof(msg)) {
+        printf("Error: Test 1.3 failed. Expected OUTPUT_BUFFER_TOO_SMALL with required size\n");
+        exit(1);
+    }
+    if (spsc_ringbuffer_read(rb, buf, &buf_len) != SUCCESS || strcmp(buf, msg) != 0) {
+        printf("Error: Test 1.3 failed. Message not read after retry\n");
+        exit(1);
+    }
+    spsc_ringbuffer_destroy(rb);
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * One producer and one consumer thread, order and content preserved     *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: producer and consumer thread\n");
+
+    spsc_ringbuffer_init(rb, rbuf, RBUF_SIZE);
+    pthread_t p;
+    pthread_create(&p, NULL, producer, rb);
+
+    for (size_t i = 0; i < NUMBER_OF_MESSAGES; i++) {
+        msg_t got;
+        size_t got_len = sizeof(got);
+        while (spsc_ringbuffer_read(rb, &got, &got_len) != SUCCESS) {
+            got_len = sizeof(got);
+            sched_yield();
+        }
+        if (got.id != i || got_len != sizeof(size_t) + 1 + (i % sizeof(got.text))) {
+            printf("Error: Test 2 failed. Expected message %zu, got %zu\n", i, got.id);
+            exit(1);
+        }
+        for (size_t j = 0; j < got_len - sizeof(size_t); j++) {
+            if (got.text[j] != (char) ('a' + (i % 26))) {
+                printf("Error: Test 2 failed. Corrupted message %zu\n", i);
+                exit(1);
+            }
+        }
+    }
+    pthread_join(p, NULL);
+    spsc_ringbuffer_destroy(rb);
+    printf("  + Test 2 passed\n");
+
+    free(rbuf);
+    free(rb);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
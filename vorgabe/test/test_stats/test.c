@@ -0,0 +1,92 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 64;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    ringbuffer_init_flags(ringbuffer_context, rbuf, rbuf_size, RBUF_VARINT);
+
+    rbstats_t stats;
+    char buffer[64];
+    size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Messages and bytes in and out, high-water mark                        *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: traffic counters\n");
+
+    ringbuffer_stats(ringbuffer_context, &stats);
+    if (stats.messages_in != 0 || stats.high_water != 0) {
+        printf("Error: Test 1.1 failed. Expected zeroed counters\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        ringbuffer_write(ringbuffer_context, "0123456789", 10);
+    }
+    len = sizeof(buffer);
+    ringbuffer_read(ringbuffer_context, buffer, &len);
+    ringbuffer_write(ringbuffer_context, "01234", 5);
+
+    ringbuffer_stats(ringbuffer_context, &stats);
+    if (stats.messages_in != 4 || stats.bytes_in != 35 || stats.messages_out != 1 || stats.bytes_out != 10) {
+        printf("Error: Test 1.2 failed. Expected 4 messages (35 bytes) in and 1 message (10 bytes) out\n");
+        exit(1);
+    }
+    if (stats.high_water != 33) {
+        printf("Error: Test 1.3 failed. Expected a high-water mark of 33 bytes, got %zu\n", stats.high_water);
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Full, empty, timeouts and wait time                                   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: failure counters\n");
+
+    if (ringbuffer_try_write(ringbuffer_context, buffer, 60) != RINGBUFFER_FULL ||
+        ringbuffer_write_until(ringbuffer_context, buffer, 60, ringbuffer_now_ns() + 10000000) != RINGBUFFER_FULL) {
+        printf("Error: Test 2.1 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+    for (int i = 0; i < 3; i++) {
+        len = sizeof(buffer);
+        ringbuffer_read(ringbuffer_context, buffer, &len);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_try_read(ringbuffer_context, buffer, &len) != RINGBUFFER_EMPTY) {
+        printf("Error: Test 2.2 failed. Expected RINGBUFFER_EMPTY\n");
+        exit(1);
+    }
+
+    ringbuffer_stats(ringbuffer_context, &stats);
+    if (stats.full != 2 || stats.empty != 1 || stats.timeouts != 1 || stats.messages_out != 4) {
+        printf("Error: Test 2.3 failed. Expected 2 full, 1 empty and 1 timeout\n");
+        exit(1);
+    }
+    if (stats.wait_ns < 10000000) {
+        printf("Error: Test 2.4 failed. Expected at least 10 ms waited\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
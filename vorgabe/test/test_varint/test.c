@@ -0,0 +1,124 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    size_t rbuf_size = 256;
+    char *rbuf = malloc(rbuf_size);
+    if (ringbuffer_context == NULL || rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+    ringbuffer_init_flags(ringbuffer_context, rbuf, rbuf_size, RBUF_VARINT);
+
+    char buffer[256];
+    size_t len;
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Small messages only take one byte of length prefix                    *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: one byte prefix\n");
+
+    /* 255 usable bytes hold 51 messages of 4 bytes + 1 byte prefix */
+    for (int i = 0; i < 51; i++) {
+        if (ringbuffer_write(ringbuffer_context, "abc", 4) != SUCCESS) {
+            printf("Error: Test 1.1 failed. Message %d should fit\n", i);
+            exit(1);
+        }
+    }
+    if (ringbuffer_write(ringbuffer_context, "abc", 4) != RINGBUFFER_FULL) {
+        printf("Error: Test 1.2 failed. Expected RINGBUFFER_FULL\n");
+        exit(1);
+    }
+    for (int i = 0; i < 51; i++) {
+        len = sizeof(buffer);
+        if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 4 || strcmp(buffer, "abc") != 0) {
+            printf("Error: Test 1.3 failed. Message %d read wrong\n", i);
+            exit(1);
+        }
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Messages of 128 bytes and more take two bytes, also across the wrap   *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: two byte prefix\n");
+
+    char msg[200];
+    for (size_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = (char) i;
+    }
+
+    /* 51 * 5 = 255 bytes in, the next prefix starts at the last byte of the memory */
+    if (ringbuffer_write(ringbuffer_context, msg, sizeof(msg)) != SUCCESS) {
+        printf("Error: Test 2.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != sizeof(msg) || memcmp(buffer, msg, len) != 0) {
+        printf("Error: Test 2.2 failed. Message read wrong\n");
+        exit(1);
+    }
+
+    /* 253 + 2 bytes exactly fill the ringbuffer */
+    if (ringbuffer_write(ringbuffer_context, rbuf, 254) != RINGBUFFER_FULL ||
+        ringbuffer_write(ringbuffer_context, msg, 253 - sizeof(msg)) != SUCCESS) {
+        printf("Error: Test 2.3 failed. Expected a two byte prefix\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 253 - sizeof(msg)) {
+        printf("Error: Test 2.4 failed. Message read wrong\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * A reservation keeps its prefix width when less is committed           *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: reserve and commit\n");
+
+    struct iovec vec[2];
+    if (ringbuffer_write_reserve(ringbuffer_context, 150, vec) != SUCCESS) {
+        printf("Error: Test 3.1 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    memcpy(vec[0].iov_base, "ok", vec[0].iov_len < 3 ? vec[0].iov_len : 3);
+    if (vec[0].iov_len < 3) {
+        memcpy(vec[1].iov_base, "ok" + vec[0].iov_len, 3 - vec[0].iov_len);
+    }
+    if (ringbuffer_write_commit(ringbuffer_context, 3) != SUCCESS ||
+        ringbuffer_write(ringbuffer_context, "next", 5) != SUCCESS) {
+        printf("Error: Test 3.2 failed. Expected SUCCESS\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 3 || strcmp(buffer, "ok") != 0) {
+        printf("Error: Test 3.3 failed. Committed message read wrong\n");
+        exit(1);
+    }
+    len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &len) != SUCCESS || len != 5 || strcmp(buffer, "next") != 0) {
+        printf("Error: Test 3.4 failed. Following message read wrong\n");
+        exit(1);
+    }
+
+    printf("  + Test 3 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}
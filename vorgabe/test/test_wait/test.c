@@ -0,0 +1,119 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define NUMBER_OF_MESSAGES 20000
+#define NUMBER_OF_WRITERS 2
+#define RBUF_SIZE 64  // bytes, both sides wait most of the time
+
+rbctx_t ringbuffer_context;
+
+void *writer(void *arg)
+{
+    size_t first = (size_t) arg;
+    for (size_t i = first; i < NUMBER_OF_MESSAGES; i += NUMBER_OF_WRITERS) {
+        if (ringbuffer_write_blocking(&ringbuffer_context, &i, sizeof(i)) != SUCCESS) {
+            printf("Error: blocking write failed\n");
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+void *blocked_reader(void *arg)
+{
+    size_t value;
+    size_t len = sizeof(value);
+    *(int *) arg = ringbuffer_read_blocking(&ringbuffer_context, &value, &len);
+    return NULL;
+}
+
+int main()
+{
+    char rbuf[RBUF_SIZE];
+    int policies[3] = {0, RBUF_WAIT_SPIN, RBUF_WAIT_BACKOFF};
+    const char *names[3] = {"park", "spin", "backoff"};
+
+    if (ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_WAIT_SPIN | RBUF_WAIT_BACKOFF) != RINGBUFFER_INVALID) {
+        printf("Error: Expected RINGBUFFER_INVALID for two wait strategies\n");
+        exit(1);
+    }
+
+    for (int p = 0; p < 3; p++) {
+        /*************************************************************************
+         * TEST 1-3:                                                             *
+         * Every message arrives once and in order per writer, whatever the     *
+         * wait strategy, and deadlines are kept                                 *
+         *************************************************************************/
+        printf("--------------------------------------------------------\n");
+        printf("Test %d: %s\n", p + 1, names[p]);
+
+        if (ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, policies[p]) != SUCCESS) {
+            printf("Error: Test %d.1 failed. Expected SUCCESS\n", p + 1);
+            exit(1);
+        }
+
+        size_t value;
+        size_t len = sizeof(value);
+        uint64_t start_ns = ringbuffer_now_ns();
+        if (ringbuffer_read_until(&ringbuffer_context, &value, &len, start_ns + 20000000) != RINGBUFFER_EMPTY
+            || ringbuffer_now_ns() - start_ns < 20000000) {
+            printf("Error: Test %d.2 failed. Expected RINGBUFFER_EMPTY after 20 ms\n", p + 1);
+            exit(1);
+        }
+
+        pthread_t threads[NUMBER_OF_WRITERS];
+        for (size_t i = 0; i < NUMBER_OF_WRITERS; i++) {
+            pthread_create(&threads[i], NULL, writer, (void *) i);
+        }
+        size_t next[NUMBER_OF_WRITERS] = {0, 1};
+        for (size_t n = 0; n < NUMBER_OF_MESSAGES; n++) {
+            len = sizeof(value);
+            if (ringbuffer_read_blocking(&ringbuffer_context, &value, &len) != SUCCESS) {
+                printf("Error: Test %d.3 failed. Expected a message\n", p + 1);
+                exit(1);
+            }
+            size_t w = value % NUMBER_OF_WRITERS;
+            if (value != next[w]) {
+                printf("Error: Test %d.4 failed. Expected %zu, got %zu\n", p + 1, next[w], value);
+                exit(1);
+            }
+            next[w] += NUMBER_OF_WRITERS;
+        }
+        for (size_t i = 0; i < NUMBER_OF_WRITERS; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        ringbuffer_destroy(&ringbuffer_context);
+        printf("  + Test %d passed\n", p + 1);
+    }
+
+    /*************************************************************************
+     * TEST 4:                                                               *
+     * A wakeup without data (close) during the spin of a backoff reader     *
+     * is not lost when it parks afterwards                                  *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 4: no lost wakeup between spinning and parking\n");
+
+    for (int round = 0; round < 200; round++) {
+        ringbuffer_init_flags(&ringbuffer_context, rbuf, RBUF_SIZE, RBUF_WAIT_BACKOFF);
+        pthread_t thread;
+        int result;
+        pthread_create(&thread, NULL, blocked_reader, &result);
+        for (int i = 0; i < round % 20; i++) {
+            sched_yield();
+        }
+        ringbuffer_close(&ringbuffer_context);
+        pthread_join(thread, NULL);
+        if (result != RINGBUFFER_CLOSED) {
+            printf("Error: Test 4 failed. Expected RINGBUFFER_CLOSED in round %d\n", round);
+            exit(1);
+        }
+        ringbuffer_destroy(&ringbuffer_context);
+    }
+    printf("  + Test 4 passed\n");
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "../include/ringbuf.h"
+#include <stdio.h>
+
+/* fill the reserved segments like fread would */
+void fill(struct iovec vec[2], const char *src, size_t n)
+{
+    size_t first = n < vec[0].iov_len ? n : vec[0].iov_len;
+    memcpy(vec[0].iov_base, src, first);
+    memcpy(vec[1].iov_base, src + first, n - first);
+}
+
+/* join the peeked segments */
+void join(struct iovec vec[2], char *dst)
+{
+    memcpy(dst, vec[0].iov_base, vec[0].iov_len);
+    memcpy(dst + vec[0].iov_len, vec[1].iov_base, vec[1].iov_len);
+}
+
+int main()
+{
+    rbctx_t *ringbuffer_context = malloc(sizeof(rbctx_t));
+    if (ringbuffer_context == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    char msg[] = "This message is written in place.";
+    size_t msg_len = strlen(msg) + 1;
+    size_t rbuf_size = 2 * (msg_len + sizeof(size_t)) + 5;
+    char *rbuf = malloc(rbuf_size);
+    if (rbuf == NULL) {
+        printf("Error: malloc failed\n");
+        exit(1);
+    }
+
+    /*************************************************************************
+     * TEST 1:                                                               *
+     * Reserve more than needed, commit the actual size                      *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 1: reserve, commit and read\n");
+
+    ringbuffer_init(ringbuffer_context, rbuf, rbuf_size);
+    struct iovec vec[2];
+    if (ringbuffer_write_reserve(ringbuffer_context, msg_len + 4, vec) != SUCCESS || vec[1].iov_len != 0) {
+        printf("Error: Test 1 failed. Expected one segment\n");
+        exit(1);
+    }
+    fill(vec, msg, msg_len);
+    if (ringbuffer_write_commit(ringbuffer_context, msg_len + 5) != RINGBUFFER_INVALID) {
+        printf("Error: Test 1 failed. Commit larger than the reservation must fail\n");
+        exit(1);
+    }
+    if (ringbuffer_write_commit(ringbuffer_context, msg_len) != SUCCESS) {
+        printf("Error: Test 1 failed. Commit failed\n");
+        exit(1);
+    }
+
+    char buffer[100];
+    size_t buffer_len = sizeof(buffer);
+    if (ringbuffer_read(ringbuffer_context, buffer, &buffer_len) != SUCCESS || buffer_len != msg_len || strcmp(buffer, msg) != 0) {
+        printf("Error: Test 1 failed. Incorrect message read\n");
+        exit(1);
+    }
+
+    printf("  + Test 1 passed\n");
+
+    /*************************************************************************
+     * TEST 2:                                                               *
+     * Aborted reservation leaves nothing behind                             *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 2: abort\n");
+
+    if (ringbuffer_write_reserve(ringbuffer_context, msg_len, vec) != SUCCESS) {
+        printf("Error: Test 2 failed. Reserve failed\n");
+        exit(1);
+    }
+    ringbuffer_write_abort(ringbuffer_context);
+    if (ringbuffer_write_commit(ringbuffer_context, 0) != RINGBUFFER_INVALID) {
+        printf("Error: Test 2 failed. Commit after abort must fail\n");
+        exit(1);
+    }
+    if (ringbuffer_context->read != ringbuffer_context->write) {
+        printf("Error: Test 2 failed. Ringbuffer not empty after abort\n");
+        exit(1);
+    }
+
+    printf("  + Test 2 passed\n");
+
+    /*************************************************************************
+     * TEST 3:                                                               *
+     * Reservation and peek across the end of the ringbuffer                 *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 3: wrapped reserve and peek\n");
+
+    ringbuffer_context->read = ringbuffer_context->end - sizeof(size_t) - 4; // prefix fits, message wraps around
+    ringbuffer_context->write = ringbuffer_context->read;
+
+    if (ringbuffer_write_reserve(ringbuffer_context, msg_len, vec) != SUCCESS || vec[1].iov_len == 0) {
+        printf("Error: Test 3 failed. Expected two segments\n");
+        exit(1);
+    }
+    fill(vec, msg, msg_len);
+    ringbuffer_write_commit(ringbuffer_context, msg_len);
+
+    if (ringbuffer_read_peek(ringbuffer_context, vec) != SUCCESS || vec[0].iov_len + vec[1].iov_len != msg_len) {
+        printf("Error: Test 3 failed. Peek failed\n");
+        exit(1);
+    }
+    join(vec, buffer);
+    if (strcmp(buffer, msg) != 0) {
+        printf("Error: Test 3 failed. Incorrect message peeked\n");
+        exit(1);
+    }
+    if (ringbuffer_read_release(ringbuffer_context) != SUCCESS || ringbuffer_read_release(ringbuffer_context) != RINGBUFFER_INVALID) {
+        printf("Error: Test 3 failed. Release failed\n");
+        exit(1);
+    }
+    if (ringbuffer_context->read != ringbuffer_context->write) {
+        printf("Error: Test 3 failed. Ringbuffer not empty after release\n");
+        exit(1);
+    }
+
+    printf("  + Test 3 passed\n");
+
+    ringbuffer_destroy(ringbuffer_context);
+    free(rbuf);
+
+    /*************************************************************************
+     * TEST 4:                                                               *
+     * Mirrored ringbuffers always hand out one segment                      *
+     *************************************************************************/
+    printf("--------------------------------------------------------\n");
+    printf("Test 4: mirrored ringbuffer\n");
+
+    if (ringbuffer_init_mirrored(ringbuffer_context, 1, 0) != SUCCESS) {
+        printf("Error: Test 4 failed. Could not map ringbuffer\n");
+        exit(1);
+    }
+    ringbuffer_context->read = ringbuffer_context->end - 10;
+    ringbuffer_context->write = ringbuffer_context->end - 10;
+    if (ringbuffer_write_reserve(ringbuffer_context, msg_len, vec) != SUCCESS || vec[1].iov_len != 0) {
+        printf("Error: Test 4 failed. Expected one segment\n");
+        exit(1);
+    }
+    fill(vec, msg, msg_len);
+    ringbuffer_write_commit(ringbuffer_context, msg_len);
+    if (ringbuffer_read_peek(ringbuffer_context, vec) != SUCCESS || vec[1].iov_len != 0 || strcmp(vec[0].iov_base, msg) != 0) {
+        printf("Error: Test 4 failed. Expected the whole message in one segment\n");
+        exit(1);
+    }
+    ringbuffer_read_release(ringbuffer_context);
+    ringbuffer_destroy(ringbuffer_context);
+
+    printf("  + Test 4 passed\n");
+
+    free(ringbuffer_context);
+
+    printf("--------------------------------------------------------\n");
+    printf("All tests passed\n");
+    return 0;
+}